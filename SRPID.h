@@ -13,6 +13,10 @@
 
   tom jennings <tom@SensitiveResearch.com>
   
+  18 oct 2026   setTC (tc, loopT) called itself, forever.
+  18 oct 2026   #define SRPID_LEAN drops the stored proportion/integral/
+  		difference intermediates and their accessors, saves 12 bytes
+		RAM per instance.
   23 sep 2020   Removed historic reference to arduino.h
   03 sep 2020   Oops: integFill() did not apply gain to seed value.
   25 aug 2020   all args are floats now, including loop time,
@@ -67,7 +71,9 @@ private:
   float propGainV;
   float diffGainV;
   float integGainV;
+#ifndef SRPID_LEAN
   float proportionV, integralV, differenceV;	/* accessible intermediates */
+#endif
   SRSmooth S;					/* our local smoother */
   float prev_d;					/* differentiation history */
 
@@ -80,7 +86,9 @@ public:
 float begin (float sf) {
 
   prev_d= 0;
+#ifndef SRPID_LEAN
   proportionV= integralV= differenceV= 0;
+#endif
 
   /* this historic default setup makes PID zero-seeking, and 
    * good at simple information extraction from a digital pin.
@@ -96,7 +104,9 @@ float begin (float sf) {
 float begin (float tc, float loopT) {
 
   prev_d= 0;
+#ifndef SRPID_LEAN
   proportionV= integralV= differenceV= 0;
+#endif
   integGainV= 1;
   propGainV= -1;  
   diffGainV= 1;
@@ -108,7 +118,9 @@ float begin (float tc, float loopT) {
 float begin (float tc, float loopT, float fill) {
 
   prev_d= 0;
+#ifndef SRPID_LEAN
   proportionV= integralV= differenceV= 0;
+#endif
   integGainV= 1;
   propGainV= -1;  
   diffGainV= 1;
@@ -122,7 +134,7 @@ float setTC (float sf) {
 }
 
 float setTC (float tc, float loopT) {
-  return setTC (tc, loopT);
+  return S.setTC (tc, loopT);
 }
 
 float setTC (float tc, float loopT, float fill) {
@@ -132,6 +144,9 @@ float setTC (float tc, float loopT, float fill) {
 
 
 float pid (float n) {
+#ifdef SRPID_LEAN
+float integralV, proportionV, differenceV;
+#endif
 
   integralV= S.smooth (n * integGainV);
   proportionV= n * propGainV;
@@ -151,15 +166,20 @@ float diffGain (float f) { return diffGainV= f; }
 float diffGain (void) { return diffGainV; }
 
 float integFill (float f) {
+#ifdef SRPID_LEAN
+float integralV;
+#endif
 
 	integralV= f * integGainV;
 	S.fill (integralV);
 	return integralV;
 }
 
+#ifndef SRPID_LEAN
 float proportion (void) { return proportionV; }
 float integral (void) { return integralV; }
 float difference (void) { return differenceV; }
+#endif
 
 
 }; /* end class */
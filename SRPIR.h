@@ -4,6 +4,42 @@
 
   tom jennings, tom@sr-ix.com
 
+  18 oct 2026  Adaptive rate: idle smoothing factors are idleT / SENSETIME
+               full-rate steps compounded, so the filter time constants
+               really are the same in real time (sf = idleT / TC made them
+               about 15% shorter at 150 mS). setAdaptive() refuses an idle
+               period no longer than SENSETIME (it froze the filters at 0).
+  18 oct 2026  Adaptive rate: the sample that wakes from idle is used at
+               full-rate weight, not idle weight (false events on spikes
+               and idle-rate noise). The IDLEWAIT quiet period starts when
+               the holdoff ends, not at setAdaptive(). Off in SRPIR_SMALL
+               (SRPIR_NOADAPT).
+  18 oct 2026  EARLY: a one-tick spike no longer fires a provisional event;
+               the slope must hold for two samples, and area counts only
+               from the second sample, while the pulse is still rising.
+  18 oct 2026  Adaptive sample rate, setAdaptive(): idles at a slow rate
+               while the signal is well inside the noise floor, back to
+               SENSETIME as soon as it heads toward threshold. Filter
+               time constants and the differentiator gain are rescaled
+               on each switch.
+  18 oct 2026  value() returns the last filter (PID) output, for the
+               golden-output harness in extras/golden.
+  18 oct 2026  EARLY mode: provisional event on the leading edge once the
+               pulse area or slope is convincing, then confirmed (PIRGLITCH
+               wide) or retracted. setMode() takes SINGLE, DUAL, EARLY;
+               true/false still work. Off in SRPIR_SMALL.
+  18 oct 2026  Dual-pulse analysis (SRPulse) runs alongside findPulse():
+               gap, lobe areas/peaks, asymmetry, direction, speed class.
+               pulse() and pulseInfo() return it. Off in SRPIR_SMALL.
+  18 oct 2026  Sensor math broken out into tick(); can be registered as a
+               task on an SRSched instead of polling loop(). event() returns
+               the latched trigger. analogRead() was reading SENSOR, not pin.
+               Library includes moved outside the class.
+               Footprint: constants are static, flags are bitfields, the
+               timer array is a member (no heap), unused gain is gone,
+               and the function-static pulse state is now per-instance
+               (more than one SRPIR shared it). #define SRPIR_SMALL drops
+               the unused timers, the debug code, and the PID intermediates.
   20 sep 2020  Missed storing pin number.
 
   This code emulates the behavior of PIR Detector/Controllers like
@@ -19,8 +55,10 @@
 
 
   This code called in a loop will return true when an event (defined below) is detected.
+  Or, begin (pin, scheduler, priority) registers the sensor processing as a task on an
+  SRSched, and event() returns true (once) after an event is detected.
 
-  Requires SRTimer, SRPID, SRSmooth.
+  Requires SRTimer, SRPID, SRSmooth, SRSched, SRPulse.
 
 
 
@@ -89,8 +127,35 @@ we deem to be a person or equiv'
 SINGLE mode is fastest-response to motion, and slightly more likely to generate false events.
 DUAL mode is slower (trigger produced after body has passed by) but unlikely to generate false events.
 
+EARLY mode is SINGLE mode without waiting for the trailing edge. From the leading edge it
+accumulates pulse area (and looks at the slope); when either is convincing it produces a
+PROVISIONAL event, usually before the pulse is PIRGLITCH wide. The event is CONFIRMED when the
+pulse reaches PIRGLITCH width, or RETRACTED if it ends short of that (a glitch). A pulse that
+reaches PIRGLITCH width without ever being convincing produces its event, already CONFIRMED,
+right then. loop() returns true for the provisional (or straight-to-confirmed) event;
+earlyStatus() says which, and later the confirm/retract; confidence() gives the score, 0..1.
+setEarly (k) scales the bounds: k == 1 needs area threshold * PIRGLITCH, or a rise of two
+thresholds per SENSETIME held for two samples in a row (so a one-sample spike doesn't count).
+
+ADAPTIVE SAMPLE RATE (any mode, off by default): after the PID output has stayed under
+threshold/2 for IDLEWAIT, sampling slows to the idle period (eg. 150 mS); the moment a sample
+would take it to 2/3 threshold, sampling goes back to SENSETIME, and that sample is used at
+full-rate weight, so a one-sample spike while idle counts no more than it would at full rate
+(at idle weight it was enough for a false event). While idle, each smoothing factor is that of
+idleT / SENSETIME full-rate steps in a row, 1 - (1 - SENSETIME/TC)^(idleT/SENSETIME), so
+SENSELPTC and SENSETC stay the same in real time, and the differentiator gain is scaled so a
+given slope gives the same output. The idle period must be longer than SENSETIME. Saves ADC conversions and float math on
+battery nodes, at the cost of up to one idle period of extra latency on the first pulse.
+Fewer samples also means less averaging of sensor noise while idle, so a noisy sensor wakes
+itself up more often.
+
 (I suspect, but have not tested, that relative speed is revealed in the time between the two pulses.)
 
+Independent of mode, every pair of opposite-polarity pulses is measured (see SRPulse.h): time
+between the two, area and peak of each, asymmetry, direction (A-hot-B-cold or A-cold-B-hot),
+and a relative speed class from the time between. pulse() returns true once per pair, and
+pulseInfo() the measurements.
+
 
 
 
@@ -118,52 +183,118 @@ Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef __SRPIR_H
 #define __SRPIR_H
 
-class SRPIR {
-
-private:
+// Footprint-optimized configuration, for many channels on small AVRs.
+// Must be defined before the first include of SRPID.h.
+//
+#ifdef SRPIR_SMALL
+#define SRPIR_NODEBUG                // no debug code or F() strings at all
+#define SRPID_LEAN                   // no stored PID intermediates
+#define SRPIR_NOPULSE                // no dual-pulse analysis
+#define SRPIR_NOEARLY                // no early trigger mode
+#define SRPIR_NOADAPT                // no adaptive sample rate
+#endif
 
 #include <SRSmooth.h>
 #include <SRPID.h>
 #include <SRTimer.h>
+#include <SRSched.h>
+#ifndef SRPIR_NOPULSE
+#include <SRPulse.h>
+#endif
 
+class SRPIR {
 
-const float DEFAULTGAIN =           5.0;   // gain for PID (kludge: 3000 if no op amp)
-const unsigned long PIRHOLDOFF =  10000;   // wait for the integrators to settle, minimum, mS
-const int PIRGLITCH =                35;   // PIR pulse width minimum, else glitch, mS
-const unsigned long PIRMAXEVENT = 20000;   // for dual-pulse, how long we'll wait for the 2nd, mS
-const unsigned long PIRMINEVENT =   500;   // for dual-pulse, how little we'll wait for the 2nd, mS
+public:
 
-const int LOOPTIMER =          0;
-const int REPORTTIMER =        1;    // debug info
-const int SENSORTIMER =        2;    // sensor signal processing timer (low pass, PID)
-const int EVENTTIMER =         3;    // internal reaction timer (eg. play songs)
-const int STIMTIMER =          4;    // delay timer for telling the flock
-const int NUMTIMERS =          5;
+enum { SINGLE, DUAL, EARLY };        // modes, see setMode()
+enum { EARLY_NONE, EARLY_PROVISIONAL, EARLY_CONFIRMED, EARLY_RETRACTED };  // earlyStatus()
+
+private:
+
+static constexpr float DEFAULTGAIN = 5.0;  // gain for PID (kludge: 3000 if no op amp)
+static const unsigned long PIRHOLDOFF =  10000;   // wait for the integrators to settle, minimum, mS
+static const int PIRGLITCH =                35;   // PIR pulse width minimum, else glitch, mS
+static const unsigned long PIRMAXEVENT = 20000;   // for dual-pulse, how long we'll wait for the 2nd, mS
+static const unsigned long PIRMINEVENT =   500;   // for dual-pulse, how little we'll wait for the 2nd, mS
+
+#ifndef SRPIR_SMALL
+static const int LOOPTIMER =          0;
+static const int REPORTTIMER =        1;    // debug info
+static const int SENSORTIMER =        2;    // sensor signal processing timer (low pass, PID)
+static const int EVENTTIMER =         3;    // internal reaction timer (eg. play songs)
+static const int STIMTIMER =          4;    // delay timer for telling the flock
+static const int NUMTIMERS =          5;
+#else
+static const int SENSORTIMER =        0;    // the only one used in here
+static const int NUMTIMERS =          1;
+#endif
 SRTimer T;
+SRTimer::_timer timerSlots [NUMTIMERS];     // T's storage, no heap
+
+static const int LOOPTIME =          10;    // how often to look (no need for speed), mS
+static const int SENSETIME =         25;    // how often we run signal processing, mS
+static const int EVENTTIME =       3000;    // how often we generate events, mS
 
-const int LOOPTIME =          10;    // how often to look (no need for speed), mS
-const int SENSETIME =         25;    // how often we run signal processing, mS
-const int EVENTTIME =       3000;    // how often we generate events, mS
+#ifndef SRPIR_NOADAPT
+static const int IDLETIME =        150;    // adaptive rate, default idle sample period, mS
+static const int IDLEWAIT =       2000;    // adaptive rate, quiet this long before idling, mS
+#endif
 
-const int SENSELPTC =        500;    // raw sensor low-pass filter TC, mS
-const int SENSETC =          500;    // event separator diff/int, mS
+static const int SENSELPTC =        500;    // raw sensor low-pass filter TC, mS
+static const int SENSETC =          500;    // event separator diff/int, mS
 
 SRSmooth SenseLP;                    // raw data filter
 SRSMPID Sense;                       // event separator
+#ifndef SRPIR_NOPULSE
+SRPulse Pulse;                       // dual-pulse analysis
+#endif
 
 int threshold;                       // noise floor (arbitrary units)
-bool PIRDualPulse;                   // single pulse (false) vs two pulse (true)
-bool debugV;                         // set true, prints out a lot of crap
-bool startup;                        // one-time startup crap
+float senseV;                        // last PID output
+#ifndef SRPIR_NOADAPT
+uint16_t senseT;                     // current sample period, mS
+uint16_t idleT;                      // adaptive rate, idle sample period, mS
+uint32_t quietT;                     // adaptive rate, last time the signal wasn't quiet
+SRSched * sched;                     // if the sensor runs as a task, on here,
+int8_t taskN;                        // as this task (to re-time it)
+#endif
+uint32_t eventT;                     // dual mode, time of the first pulse
+uint32_t pulseT;                     // findPulse(), earlyPulse(), time of the leading edge
+#ifndef SRPIR_NOEARLY
+float earlyArea;                     // early mode, pulse area so far
+float earlyPrev;                     //   previous sample, for slope
+float earlySlope;                    //   previous slope
+float earlyConf;                     //   confidence, 0..1
+float earlyK;                        //   confidence bound scale
+enum { EIDLE, EARMED, EFIRED, ECONFIRMED };
+#endif
 
 // From the outside world.
 //
-int pin;                             // analog input pin
-float gain;                          // PID gain
+uint8_t pin;                         // analog input pin
 
-// To the outside world.
+// Flags, as bitfields: 14 bits (two bytes) in the default build, 6 bits
+// (one byte) in SRPIR_SMALL.
 //
-bool trig;
+uint8_t mode : 2;                    // SINGLE, DUAL, EARLY
+#ifndef SRPIR_NODEBUG
+bool debugV : 1;                     // set true, prints out a lot of crap
+#endif
+bool startup : 1;                    // one-time startup crap
+bool secondPulse : 1;                // dual mode, which pulse we need
+bool inPulse : 1;                    // findPulse(), between the edges
+bool trig : 1;                       // to the outside world; latched, cleared by event()
+#ifndef SRPIR_NOADAPT
+bool adaptive : 1;                   // adaptive sample rate on
+bool idle : 1;                       // adaptive rate, sampling at idleT
+#endif
+#ifndef SRPIR_NOPULSE
+bool newPulse : 1;                   // likewise, cleared by pulse()
+#endif
+#ifndef SRPIR_NOEARLY
+uint8_t earlyState : 2;              // EIDLE etc
+uint8_t earlyV : 2;                  // EARLY_xxx, latched, cleared by earlyStatus()
+#endif
 
 public:
 
@@ -172,12 +303,14 @@ int n;
 
   pin= p;
   pinMode (pin, INPUT_PULLUP);
-  T.begin (NUMTIMERS);
+  T.begin (NUMTIMERS, timerSlots);
+  T.setTimer (SENSORTIMER, SENSETIME);       // run the math
+#ifndef SRPIR_SMALL
   T.setTimer (LOOPTIMER, LOOPTIME);          // minimize load
   T.setTimer (REPORTTIMER, 1000);            // printing debug shit
-  T.setTimer (SENSORTIMER, SENSETIME);       // run the math
   T.setTimer (EVENTTIMER, EVENTTIME);        // event generation
   T.setTimer (STIMTIMER, 9999);              // set in loop()
+#endif
  
   // Startup the low-pass filter and the PID detector. Attempt to seed the
   // filter and PID with a reasonable value off the sensor, to speed its
@@ -187,53 +320,171 @@ int n;
   SenseLP.begin (SENSELPTC, SENSETIME, n);   // analog sensor low-pass filter
   n= SenseLP.smooth (n);                     // "current value" (kinda sorta)
   Sense.begin   (SENSETC, SENSETIME, n);     // initial PID values
+  senseV= 0;
+#ifndef SRPIR_NOADAPT
+  senseT= SENSETIME;
+  idleT= IDLETIME;
+  quietT= 0;
+  sched= 0;
+  taskN= -1;
+  adaptive= idle= false;
+#endif
+#ifndef SRPIR_NOPULSE
+  Pulse.begin (PIRGLITCH, PIRMAXEVENT);
+  newPulse= false;
+#endif
 
   setGain (DEFAULTGAIN);                     // reasonable gain
-  setMode (false);                           // single pulse mode default
+  setMode (SINGLE);                          // single pulse mode default
+#ifndef SRPIR_NOEARLY
+  setEarly (1.0);
+  earlyState= EIDLE;
+  earlyV= EARLY_NONE;
+  earlyConf= earlyPrev= earlySlope= 0;
+#endif
   setThreshold (8);                          // low threshold
+  debug (false);
+  trig= secondPulse= inPulse= false;
   startup= true;
 }
 
+// As above, but the sensor processing runs as a task on scheduler S, every
+// SENSETIME mS, instead of from loop(). Returns the task number, or -1 if
+// the scheduler is full.
+//
+int begin (int p, SRSched & S, uint8_t prio) {
+int n;
+
+  begin (p);
+  n= S.addTask (task, this, SENSETIME, prio);
+#ifndef SRPIR_NOADAPT
+  taskN= n;
+  if (n >= 0) sched= &S;
+#endif
+  return n;
+}
+
 
 // Runs the sensor machines, returns true if an event is detected.
 //
 bool loop () {
-static bool h = false;                       // dual mode, which pulse we need
+
+  if (T.timer (SENSORTIMER) == false) return false;
+  return tick ();
+}
+
+// Returns true once for each event detected by the scheduled task.
+//
+bool event () {
+
+  if (! trig) return false;
+  trig= false;
+  return true;
+}
+
+#ifndef SRPIR_NOPULSE
+// Returns true once for each pulse pair measured.
+//
+bool pulse () {
+
+  if (! newPulse) return false;
+  newPulse= false;
+  return true;
+}
+
+// The measurements of the last pulse pair.
+//
+const SRPulse::result & pulseInfo () {
+
+  return Pulse.last ();
+}
+#endif
+
+// SRSched callback.
+//
+static void task (void * p) {
+
+  ((SRPIR *) p)->tick ();
+}
+
+
+// One sample of the sensor machines, returns true if an event is detected.
+//
+bool tick () {
 float r, v;
-static long t;
 int n;
+bool e;
 
-  if (T.timer (SENSORTIMER) == false) return false;
+  r= analogRead (pin);                        // raw sensor, noisy
 
-  r= analogRead (SENSOR);                     // raw sensor, noisy
+  // Adaptive rate, idle: one idle sample stands for idleT mS of signal,
+  // so a one-tick spike (or just the idle rate's extra noise) would go
+  // into the filters at idleT / SENSETIME times its full-rate weight,
+  // and wake us with a false pulse. If this sample would wake us, go
+  // back to full rate first, and use it at full-rate weight.
+  //
+#ifndef SRPIR_NOADAPT
+  if (idle && wakes (r)) setRate (SENSETIME);
+#endif
   v= SenseLP.smooth (r);                      // removes most noise
   v= Sense.pid (v);                           // low-pass, differentiator removes DC
+  senseV= v;
 
-  if (millis() < PIRHOLDOFF) return false;    // let everything settle
+  if (millis() < PIRHOLDOFF) {                // let everything settle
+#ifndef SRPIR_NOADAPT
+    quietT= millis();
+#endif
+    return false;
+  }
 
-  trig= false;
+#ifndef SRPIR_NOADAPT
+  if (adaptive) adapt (v);
+#endif
+
+#ifndef SRPIR_NOPULSE
+  if (Pulse.sample (v, threshold, millis())) {
+    newPulse= true;
+
+#ifndef SRPIR_NODEBUG
+    if (debugV) {
+      Serial.print (F("SRPIR pulse pair gap="));
+      Serial.print (Pulse.last().gap);
+      Serial.print (F(" dir="));
+      Serial.print (Pulse.last().direction);
+      Serial.print (F(" asym="));
+      Serial.print (Pulse.last().asymmetry);
+      Serial.print (F(" speed="));
+      Serial.println (Pulse.last().speed);
+    }
+#endif
+  }
+#endif
+
+  e= false;
 
-  switch (PIRDualPulse) {
+  switch (mode) {
 
     // DUAL PULSE MODE
     //
-    case true:
-      switch (h) {
+    case DUAL:
+      switch (secondPulse) {
 
           // A positive-going pulse of sufficient width starts event detection.
           //
           case false:
             n= findPulse (v, threshold, PIRGLITCH);
             if (n > 0) {
-              h= true;
-              t= millis();
+              secondPulse= true;
+              eventT= millis();
   
+#ifndef SRPIR_NODEBUG
               if (debugV) {
   	      Serial.print (F("SRPIR pos pulse height="));
   	      Serial.print (v);
   	      Serial.print (F(" width="));
   	      Serial.println (n);
               }
+#endif
             }
             break;
 
@@ -243,46 +494,61 @@ int n;
           case true:
             n= findPulse (v, -threshold, PIRGLITCH);
             if (n > 0) {
-              h= false;
-              trig= true;
+              secondPulse= false;
+              e= true;
 
+#ifndef SRPIR_NODEBUG
               if (debugV) {
   	      Serial.print (F("SRPIR neg pulse height="));
   	      Serial.print (v);
   	      Serial.print (F(" width="));
   	      Serial.print (n);
                 Serial.print (F(" event width"));
-              Serial.println (millis() - t);
+              Serial.println (millis() - eventT);
               }
+#endif
             }
-            if (millis() - t > PIRMAXEVENT) {
-              h= false;
+            if (millis() - eventT > PIRMAXEVENT) {
+              secondPulse= false;
   
+#ifndef SRPIR_NODEBUG
               if (debugV) {
                 Serial.print (F("SRPIR no neg pulse, start over"));
               }
+#endif
             }
             break;
         }
         break;
 
+#ifndef SRPIR_NOEARLY
+    // EARLY TRIGGER MODE
+    //
+    case EARLY:
+      e= earlyPulse (v);
+      break;
+#endif
+
     // SINGLE PULSE MODE
     //
-    case false:
+    default:
       n= findPulse (v, threshold, PIRGLITCH);
       if (n > 0) {
-        trig= true;
+        e= true;
 
+#ifndef SRPIR_NODEBUG
         if (debugV) {
           Serial.print (F("SRPIR pos pulse height="));
           Serial.print (v);
           Serial.print (F(" width="));
           Serial.println (n);
         }
+#endif
       }
       break;
   }
-  return trig;
+  if (e) trig= true;
+  return e;
 }
 
 
@@ -292,20 +558,18 @@ private:
 // negative.
 //
 int findPulse (int h, int thresh, int width) {
-static bool s = false;
-static long t;
 int r;
 
   r= 0;
-  switch (s) {
+  switch (inPulse) {
 
     // Await leading edge.
     //
     case false:
       if (((thresh > 0) && (h >= thresh)) ||
           ((thresh < 0) && (h <= thresh))) {
-        s= true;
-        t= millis();
+        inPulse= true;
+        pulseT= millis();
       }
       break;
 
@@ -314,29 +578,206 @@ int r;
     case true:
       if (((thresh > 0) && (h < thresh)) ||
           ((thresh < 0) && (h > thresh))) {
-        s= false;
-        r= millis() - t;
+        inPulse= false;
+        r= millis() - pulseT;
         if (r < width) r= 0;
       }
   }
   return r;
 }
 
+#ifndef SRPIR_NOADAPT
+// Adaptive sample rate: idle slowly once the signal has stayed well inside
+// the noise floor for IDLEWAIT. Waking is wakes(), from tick().
+//
+void adapt (float v) {
+uint32_t t;
+
+  if (v < 0) v= -v;
+  t= millis();
+  if ((v >= threshold / 2.0) || secondPulse || inPulse) quietT= t;   // not while an event is under way
+  if (! idle && (t - quietT >= (uint32_t) IDLEWAIT)) setRate (idleT);
+}
+
+// Adaptive sample rate, idle: true if raw sample R would take the filter
+// output toward threshold. Tried on copies; the filters are left alone.
+//
+bool wakes (float r) {
+SRSmooth lp= SenseLP;
+SRSMPID s= Sense;
+float v;
+
+  v= s.pid (lp.smooth (r));
+  if (v < 0) v= -v;
+  return v >= threshold / 1.5;
+}
+
+// Sample every R mS, and rescale the filters to suit. Full rate is
+// exactly what begin() set up.
+//
+void setRate (uint16_t r) {
+
+  senseT= r;
+  idle= r != SENSETIME;
+  if (idle) {
+    SenseLP.setSF (stepSF (SENSELPTC, r));
+    Sense.setTC (stepSF (SENSETC, r));
+  }
+  else {
+    SenseLP.setTC (SENSELPTC, SENSETIME);
+    Sense.setTC (SENSETC, SENSETIME);
+  }
+  Sense.diffGain (Sense.propGain () * SENSETIME / r);
+  if (sched) sched->setInterval (taskN, r);
+  else T.setTimer (SENSORTIMER, r);
+}
+
+// Smoothing factor for one sample every R mS that does what R / SENSETIME
+// full-rate samples do, for a smoother of time constant TC mS.
+//
+float stepSF (int tc, uint16_t r) {
+
+  return 1.0 - pow (1.0 - (float) SENSETIME / tc, (float) r / SENSETIME);
+}
+#endif
+
+#ifndef SRPIR_NOEARLY
+// Early trigger. Returns true for the provisional (or straight-to-confirmed)
+// event; confirm and retract are reported through earlyStatus().
+//
+bool earlyPulse (float v) {
+uint32_t w;
+float a, sl, s2;
+bool r;
+
+  // the slope has to hold for two samples; a one-tick spike rises then falls.
+  //
+  r= false;
+  sl= (v - earlyPrev) / rate ();
+  s2= sl < earlySlope ? sl : earlySlope;
+  earlyPrev= v;
+  earlySlope= sl;
+
+  // Await leading edge.
+  //
+  if (earlyState == EIDLE) {
+    if (v < threshold) return false;
+    earlyState= EARMED;
+    pulseT= millis();
+    earlyArea= earlyConf= 0;
+  }
+  w= millis() - pulseT;
+
+  // Trailing edge: long enough is a pulse, else a glitch.
+  //
+  if (v < threshold) {
+    if (w >= PIRGLITCH) {
+      if (earlyState == EARMED) r= true;
+      if (earlyState != ECONFIRMED) earlyV= EARLY_CONFIRMED;
+    }
+    else if (earlyState == EFIRED) earlyV= EARLY_RETRACTED;
+    earlyState= EIDLE;
+    return r;
+  }
+
+  // Inside the pulse. Area counts from the second sample on, and only while
+  // still rising; a one-tick spike is over threshold but already falling.
+  //
+  earlyArea += v * rate ();
+  a= (w > 0 && sl >= 0) ? earlyArea / (earlyK * threshold * PIRGLITCH) : 0;
+  s2= s2 * SENSETIME / (earlyK * 2 * threshold);
+  if (s2 > a) a= s2;
+  if (a > earlyConf) earlyConf= a > 1.0 ? 1.0 : a;
+
+  switch (earlyState) {
+    case EARMED:
+      if (w >= PIRGLITCH) {
+        earlyState= ECONFIRMED;
+        earlyV= EARLY_CONFIRMED;
+        r= true;
+      }
+      else if (earlyConf >= 1.0) {
+        earlyState= EFIRED;
+        earlyV= EARLY_PROVISIONAL;
+        r= true;
+      }
+      break;
+
+    case EFIRED:
+      if (w >= PIRGLITCH) {
+        earlyState= ECONFIRMED;
+        earlyV= EARLY_CONFIRMED;
+      }
+      break;
+  }
+
+#ifndef SRPIR_NODEBUG
+  if (r && debugV) {
+    Serial.print (F("SRPIR early "));
+    Serial.print (earlyState == ECONFIRMED ? F("confirmed") : F("provisional"));
+    Serial.print (F(" conf="));
+    Serial.print (earlyConf);
+    Serial.print (F(" after "));
+    Serial.println (w);
+  }
+#endif
+  return r;
+}
+#endif
+
 public:
 
-// Turn on/off debug chatter.
+#ifndef SRPIR_NOEARLY
+// Early mode: returns the latest EARLY_xxx status, once; EARLY_NONE if
+// nothing new.
+//
+uint8_t earlyStatus () {
+uint8_t s;
+
+  s= earlyV;
+  earlyV= EARLY_NONE;
+  return s;
+}
+
+// Early mode: confidence score of the current or last pulse, 0..1.
+//
+float confidence () {
+
+  return earlyConf;
+}
+
+// Early mode: scale the confidence bounds; larger is more cautious.
+//
+void setEarly (float k) {
+
+  earlyK= k;
+}
+#endif
+
+// The last filter output, the signal the pulse detectors see.
+//
+float value () {
+
+  return senseV;
+}
+
+// Turn on/off debug chatter. Does nothing if SRPIR_NODEBUG.
 //
 void debug (bool d) {
 
+#ifndef SRPIR_NODEBUG
   debugV= d;
+#else
+  (void) d;
+#endif
 }
 
 
-// Set PIR mode, single (0) or double (1) pulse.
+// Set PIR mode, SINGLE (0, false), DUAL (1, true) pulse, or EARLY.
 //
-void setMode (bool m) {
+void setMode (uint8_t m) {
 
-  PIRDualPulse= m;
+  mode= m;
 }
 
 // Set noise/signal threshold.
@@ -347,13 +788,41 @@ void setThreshold (int n) {
 }
 
 
-// Set PID gains.
+// Set PID gains. The differentiator gain is per SENSETIME.
 //
 void setGain (float f) {
 
   Sense.propGain (f);
   Sense.integGain (-f);
-  Sense.diffGain (f);
+  Sense.diffGain (f * SENSETIME / rate ());
+}
+
+#ifndef SRPIR_NOADAPT
+// Adaptive sample rate on/off; idle sample period, mS. Returns false,
+// and leaves adaptive rate off, if the idle period isn't longer than
+// SENSETIME.
+//
+bool setAdaptive (bool a, uint16_t idleTime = IDLETIME) {
+bool ok;
+
+  ok= idleTime > SENSETIME;
+  adaptive= a && ok;
+  if (ok) idleT= idleTime;
+  quietT= millis();
+  if (senseT != SENSETIME) setRate (SENSETIME);
+  return ok;
+}
+#endif
+
+// The current sample period, mS.
+//
+unsigned rate () {
+
+#ifndef SRPIR_NOADAPT
+  return senseT;
+#else
+  return SENSETIME;
+#endif
 }
 
 
@@ -0,0 +1,203 @@
+/*
+
+  PIR dual-pulse analysis
+
+  Fed one filtered sample at a time (the SRSMPID output, same as
+  findPulse() sees), this measures each lobe above +threshold or below
+  -threshold, and when a lobe is followed by one of the opposite
+  polarity, reports the pair:
+
+    gap        peak to peak time, mS
+    width      each lobe, leading to trailing edge, mS
+    area       each lobe, sum of |signal| x mS while over threshold
+    peak       each lobe, largest |signal|
+    asymmetry  (area1 - area2) / (area1 + area2), -1 .. 1
+    direction  +1 A-hot-B-cold (positive lobe first),
+               -1 A-cold-B-hot (negative lobe first)
+    speed      relative speed class from the gap; the time between the
+               two lobes is the time the body takes to cross from one
+               cell's view to the other's.
+
+  Everything is running sums and the last completed lobe; no samples
+  are stored. Sample time is passed in, so uneven sample intervals
+  are fine.
+
+  The speed class boundaries are uncalibrated defaults; they depend on
+  the lens and the distance to the path. Set them with setSpeed().
+
+
+  tom jennings <tom@SensitiveResearch.com>
+
+  18 oct 2026	written.
+  18 oct 2026	the first sample after begin() has no time span; it got
+		the whole time since begin() (the holdoff, in SRPIR),
+		and a lobe starting on it had its area hugely inflated.
+
+copyright tom jennings 2026
+
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+*/
+
+#ifndef SR_PULSE
+#define SR_PULSE
+
+#include "Arduino.h"
+
+class SRPulse {
+
+public:
+
+enum { SPEED_FAST, SPEED_WALK, SPEED_SLOW };
+
+struct lobe {
+  uint32_t start;                    // leading edge, mS
+  uint32_t peakT;                    // time of peak, mS
+  uint16_t width;                    // leading to trailing edge, mS
+  float area;                        // sum |v| x mS
+  float peak;                        // largest |v|
+  int8_t polarity;                   // +1, -1; 0 == none
+};
+
+struct result {
+  uint32_t T;                        // time reported (trailing edge of 2nd lobe), mS
+  uint16_t gap;                      // peak to peak, mS
+  struct lobe first, second;
+  float asymmetry;                   // -1 .. 1
+  int8_t direction;                  // +1 A hot B cold, -1 A cold B hot
+  uint8_t speed;                     // SPEED_xxx
+};
+
+private:
+
+struct lobe cur;                     // lobe in progress
+struct lobe prev;                    // last completed lobe, awaiting its partner
+struct result res;
+uint32_t lastT;                      // previous sample time
+bool sampled;                        // lastT is valid
+uint16_t glitch;                     // minimum lobe width, mS
+uint16_t maxGap;                     // longest wait for the 2nd lobe, mS
+uint16_t fastGap, slowGap;           // speed class boundaries, mS
+
+public:
+
+void begin (uint16_t minWidth, uint16_t maxWait) {
+
+  glitch= minWidth;
+  maxGap= maxWait;
+  setSpeed (400, 1500);
+  cur.polarity= prev.polarity= 0;
+  sampled= false;
+}
+
+/* set the speed class boundaries; a gap shorter than fast is SPEED_FAST,
+longer than slow is SPEED_SLOW. */
+
+void setSpeed (uint16_t fast, uint16_t slow) {
+
+  fastGap= fast;
+  slowGap= slow;
+}
+
+/* one sample V at time T, mS; returns true when a pair has completed. */
+
+bool sample (float v, int thresh, uint32_t t) {
+int8_t p;
+uint32_t dt;
+float a;
+bool r;
+
+  dt= sampled ? t - lastT : 0;       // first sample spans no time
+  lastT= t;
+  sampled= true;
+  if (dt > maxGap) dt= 0;            // a long stall
+
+  p= 0;
+  if (v >= thresh) p= 1;
+  else if (v <= -thresh) p= -1;
+  a= v < 0 ? -v : v;
+
+  // partner did not show up in time.
+  //
+  if (prev.polarity && (t - prev.peakT > maxGap)) prev.polarity= 0;
+
+  // Inside a lobe, accumulate.
+  //
+  if (cur.polarity && (p == cur.polarity)) {
+    cur.area += a * dt;
+    if (a > cur.peak) {
+      cur.peak= a;
+      cur.peakT= t;
+    }
+    return false;
+  }
+
+  // Trailing edge (maybe straight into the opposite lobe).
+  //
+  r= false;
+  if (cur.polarity) {
+    cur.width= t - cur.start;
+    if (cur.width >= glitch) r= pair (t);
+    cur.polarity= 0;
+  }
+
+  // Leading edge.
+  //
+  if (p) {
+    cur.polarity= p;
+    cur.start= cur.peakT= t;
+    cur.area= a * dt;
+    cur.peak= a;
+  }
+  return r;
+}
+
+/* the last completed pair. */
+
+const struct result & last (void) {
+
+  return res;
+}
+
+
+private:
+
+/* cur is a valid lobe; pair it with prev, or make it prev. */
+
+bool pair (uint32_t t) {
+
+  if (! prev.polarity || (prev.polarity == cur.polarity)) {
+    prev= cur;
+    return false;
+  }
+
+  res.T= t;
+  res.first= prev;
+  res.second= cur;
+  res.gap= cur.peakT - prev.peakT;
+  res.asymmetry= (prev.area - cur.area) / (prev.area + cur.area);
+  res.direction= prev.polarity;
+  if (res.gap < fastGap) res.speed= SPEED_FAST;
+  else if (res.gap > slowGap) res.speed= SPEED_SLOW;
+  else res.speed= SPEED_WALK;
+
+  prev.polarity= 0;
+  return true;
+}
+
+}; /* end class */
+
+
+#endif
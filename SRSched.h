@@ -0,0 +1,282 @@
+/*
+
+ SR cooperative scheduler.
+
+ periodic and one-shot tasks (callbacks) dispatched from a single
+ run() call in loop(), on the same millis() timebase and wrap-safe
+ arithmetic as SRTimer.
+
+ tasks are kept on a list sorted by deadline, so run() looks only
+ at the head of the list, not at every slot. when more than one task
+ is due, the one with the best (lowest) priority number runs first.
+ one task runs per call to run(); nothing is preemptive, a task
+ runs to completion.
+
+ each task keeps run count, runtime (uS), worst lateness (mS), and
+ overrun count (a periodic task that finished after its next deadline
+ had already passed; missed periods are skipped, not bunched up).
+
+ tom jennings
+
+ 18 oct 2026 written, to replace hand-written loops polling SRTimer.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ version 2 as published by the Free Software Foundation.
+
+*/
+
+#include "Arduino.h"
+
+#ifndef SR_SCHED
+#define SR_SCHED
+
+#ifndef SRSCHED_MAXTASKS
+#define SRSCHED_MAXTASKS 8                  // table size, define before include to change
+#endif
+
+class SRSched {
+
+public:
+
+typedef void (* task_fn) (void *);
+
+struct stats {
+	uint32_t runs;			// times dispatched
+	uint32_t total;			// total runtime, uS
+	uint32_t worst;			// longest single run, uS
+	uint32_t late;			// worst dispatch lateness, mS
+	uint16_t overruns;		// periodic deadlines missed
+};
+
+	void begin (void);
+	int addTask (task_fn f, void * arg, uint32_t interval, uint8_t prio);
+	int addOneShot (task_fn f, void * arg, uint32_t delay, uint8_t prio);
+	bool cancel (unsigned n);
+	bool setInterval (unsigned n, uint32_t m);
+	bool trigTask (unsigned n);
+	bool run (void);
+	uint32_t untilNext (void);
+	const struct stats & getStats (unsigned n);
+	bool resetStats (unsigned n);
+
+private:
+
+static const uint8_t NONE = 0xff;
+
+struct _task {
+	task_fn fn;			// callback, 0 if slot free
+	void * arg;			// callback argument
+	uint32_t T;			// deadline, mS
+	uint32_t interval;		// period, mS; 0 == one-shot
+	uint8_t prio;			// 0 is most urgent
+	uint8_t next;			// deadline list link
+	struct stats s;
+};
+
+	struct _task tasks [SRSCHED_MAXTASKS];
+	uint8_t head;			// earliest deadline
+
+	int add (task_fn f, void * arg, uint32_t interval, uint32_t delay, uint8_t prio);
+	void link (uint8_t n);
+	void unlink (uint8_t n);
+	bool linked (uint8_t n);
+};
+
+
+void SRSched::begin (void) {
+unsigned n;
+
+  head= NONE;
+  for (n= 0; n < SRSCHED_MAXTASKS; n++) {
+    tasks[n].fn= 0;
+    tasks[n].next= NONE;
+  }
+}
+
+// add a task that runs every INTERVAL mS, first run INTERVAL mS from now.
+// returns the task number, or -1 if the table is full.
+//
+int SRSched::addTask (task_fn f, void * arg, uint32_t interval, uint8_t prio) {
+
+  if (interval == 0) return -1;
+  return add (f, arg, interval, interval, prio);
+}
+
+// add a task that runs once, DELAY mS from now. its slot is freed when it runs.
+//
+int SRSched::addOneShot (task_fn f, void * arg, uint32_t delay, uint8_t prio) {
+
+  return add (f, arg, 0, delay, prio);
+}
+
+// remove task N.
+//
+bool SRSched::cancel (unsigned n) {
+
+  if (n >= SRSCHED_MAXTASKS || ! tasks[n].fn) return false;
+  unlink (n);
+  tasks[n].fn= 0;
+  return true;
+}
+
+// change the period of task N; next run is M mS from now.
+//
+bool SRSched::setInterval (unsigned n, uint32_t m) {
+
+  if (n >= SRSCHED_MAXTASKS || ! tasks[n].fn || m == 0) return false;
+  unlink (n);
+  tasks[n].interval= m;
+  tasks[n].T= millis() + m;
+  link (n);
+  return true;
+}
+
+// make task N due immediately (leaving its period alone).
+//
+bool SRSched::trigTask (unsigned n) {
+
+  if (n >= SRSCHED_MAXTASKS || ! tasks[n].fn) return false;
+  unlink (n);
+  tasks[n].T= millis();
+  link (n);
+  return true;
+}
+
+// run the most urgent due task, if any. returns true if something ran.
+//
+bool SRSched::run (void) {
+uint32_t t, us;
+uint8_t n, i;
+struct _task * p;
+
+  if (head == NONE) return false;
+  t= millis();
+  if ((int32_t) (t - tasks[head].T) < 0) return false;   // nothing due
+
+  // due tasks are all at the front of the list; pick the best priority.
+  //
+  n= head;
+  for (i= tasks[head].next; i != NONE; i= tasks[i].next) {
+    if ((int32_t) (t - tasks[i].T) < 0) break;
+    if (tasks[i].prio < tasks[n].prio) n= i;
+  }
+  p= &tasks[n];
+  unlink (n);
+
+  if (t - p->T > p->s.late) p->s.late= t - p->T;
+
+  us= micros();
+  (* p->fn) (p->arg);
+  us= micros() - us;
+
+  ++p->s.runs;
+  p->s.total += us;
+  if (us > p->s.worst) p->s.worst= us;
+
+  // the callback may have cancelled or re-timed itself.
+  //
+  if (! p->fn || linked (n)) return true;
+
+  if (p->interval == 0) {
+    p->fn= 0;                           // one-shot is done
+    return true;
+  }
+
+  p->T += p->interval;
+  t= millis();
+  if ((int32_t) (t - p->T) >= 0) {      // missed the next deadline
+    ++p->s.overruns;
+    p->T= t + p->interval;
+  }
+  link (n);
+  return true;
+}
+
+// return mS until the next task is due, 0 if one is due now.
+// UINT32_MAX if no tasks.
+//
+uint32_t SRSched::untilNext (void) {
+int32_t e;
+
+  if (head == NONE) return UINT32_MAX;
+  e= tasks[head].T - millis();
+  return e > 0 ? e : 0;
+}
+
+// return the statistics for task N.
+//
+const struct SRSched::stats & SRSched::getStats (unsigned n) {
+
+  if (n >= SRSCHED_MAXTASKS) n= 0;
+  return tasks[n].s;
+}
+
+bool SRSched::resetStats (unsigned n) {
+
+  if (n >= SRSCHED_MAXTASKS) return false;
+  tasks[n].s.runs= tasks[n].s.total= tasks[n].s.worst= tasks[n].s.late= 0;
+  tasks[n].s.overruns= 0;
+  return true;
+}
+
+
+int SRSched::add (task_fn f, void * arg, uint32_t interval, uint32_t delay, uint8_t prio) {
+uint8_t n;
+
+  if (! f) return -1;
+  for (n= 0; n < SRSCHED_MAXTASKS; n++) {
+    if (! tasks[n].fn) break;
+  }
+  if (n >= SRSCHED_MAXTASKS) return -1;
+
+  tasks[n].fn= f;
+  tasks[n].arg= arg;
+  tasks[n].interval= interval;
+  tasks[n].prio= prio;
+  tasks[n].T= millis() + delay;
+  tasks[n].next= NONE;
+  resetStats (n);
+  link (n);
+  return n;
+}
+
+// insert task N into the deadline list; equal deadlines keep arrival order.
+//
+void SRSched::link (uint8_t n) {
+uint8_t * pp;
+
+  for (pp= &head; *pp != NONE; pp= &tasks[*pp].next) {
+    if ((int32_t) (tasks[n].T - tasks[*pp].T) < 0) break;
+  }
+  tasks[n].next= *pp;
+  *pp= n;
+}
+
+// remove task N from the deadline list, if it is there.
+//
+void SRSched::unlink (uint8_t n) {
+uint8_t * pp;
+
+  for (pp= &head; *pp != NONE; pp= &tasks[*pp].next) {
+    if (*pp == n) {
+      *pp= tasks[n].next;
+      tasks[n].next= NONE;
+      return;
+    }
+  }
+}
+
+// true if task N is on the deadline list.
+//
+bool SRSched::linked (uint8_t n) {
+uint8_t i;
+
+  for (i= head; i != NONE; i= tasks[i].next) {
+    if (i == n) return true;
+  }
+  return false;
+}
+
+
+#endif
@@ -6,6 +6,10 @@
 
  tom jennings
 
+ 18 oct 2026 begin (n, slots) runs the timers out of caller-supplied
+             storage, eg. a static array; no heap. begin (n) frees
+             the previous array if called again, and the destructor
+             frees it.
  11 mar 2019 _timer interval now unsigned. every
              method checks incoming timer number. all
              methods except begin have return value 
@@ -37,14 +41,17 @@
 
 class SRTimer {
 
+public: 
 
 struct _timer {
 	uint32_t T;		// future time of event, mS
 	uint32_t interval;	// timer period length, mS
 };
 
-public: 
+	SRTimer () : numTimers (0), timers (0), heap (false) { }
+	~SRTimer () { if (heap) delete [] timers; }
 	void begin (unsigned n);
+	void begin (unsigned n, struct _timer * slots);
 	bool timer (unsigned n);
 	bool setTimer (unsigned n, unsigned m);
 	bool setDeciTimer (unsigned n, unsigned d);
@@ -56,13 +63,27 @@ public:
 private:
 	unsigned numTimers;
 	struct _timer * timers;
+	bool heap;		// timers came from new
+
+	SRTimer (const SRTimer &);		// not copyable, owns timers
+	SRTimer & operator= (const SRTimer &);
 };
 
 
 void SRTimer::begin (unsigned n) {
 
-	timers= new _timer [numTimers= n];
-	for (n= 0; n < numTimers; n++) {
+	begin (n, new _timer [n]);		// frees the previous array
+	heap= true;
+};
+
+// as above, but SLOTS (N of them) is the storage.
+//
+void SRTimer::begin (unsigned n, struct _timer * slots) {
+
+	if (heap) delete [] timers;
+	heap= false;
+	timers= slots;
+	for (numTimers= n, n= 0; n < numTimers; n++) {
 		timers[n].T= timers[n].interval= 0;
 	}
 };
@@ -0,0 +1,58 @@
+/*
+
+  SRPIR footprint report, and eight sensor channels on one ATmega328.
+
+  Prints sizeof() for each class, as built. Flash usage is what the
+  IDE (or arduino-cli compile) reports for this sketch; build it with
+  and without SRPIR_SMALL to compare.
+
+  tom jennings
+
+  18 oct 2026
+
+*/
+
+#define SRPIR_SMALL                  // footprint-optimized SRPIR
+#define SRSCHED_MAXTASKS 8           // one task per channel
+
+#include <SRPIR.h>                   // first, so SRPIR_SMALL reaches SRPID.h
+
+const int NUMCHANNELS = 8;
+const uint8_t pins [NUMCHANNELS] = { A0, A1, A2, A3, A4, A5, A6, A7 };  // A6, A7: Nano/Pro Mini
+
+SRSched S;
+SRPIR PIR [NUMCHANNELS];
+
+
+void setup () {
+int i;
+
+  Serial.begin (9600);
+
+  Serial.print (F("sizeof SRTimer "));  Serial.println (sizeof (SRTimer));
+  Serial.print (F("sizeof SRSmooth ")); Serial.println (sizeof (SRSmooth));
+  Serial.print (F("sizeof SRSMPID "));  Serial.println (sizeof (SRSMPID));
+  Serial.print (F("sizeof SRSched "));  Serial.println (sizeof (SRSched));
+  Serial.print (F("sizeof SRPIR "));    Serial.println (sizeof (SRPIR));
+  Serial.print (F("total, "));
+  Serial.print (NUMCHANNELS);
+  Serial.print (F(" channels "));
+  Serial.println (sizeof (S) + sizeof (PIR));
+
+  S.begin ();
+  for (i= 0; i < NUMCHANNELS; i++) {
+    PIR[i].begin (pins[i], S, 0);
+  }
+}
+
+void loop () {
+int i;
+
+  S.run ();
+  for (i= 0; i < NUMCHANNELS; i++) {
+    if (PIR[i].event ()) {
+      Serial.print (F("event channel "));
+      Serial.println (i);
+    }
+  }
+}
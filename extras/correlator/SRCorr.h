@@ -0,0 +1,488 @@
+/*
+
+  Streaming cross-sensor event correlator, for multi-PIR installations.
+  Runs on the host (or anything with a few hundred K of RAM).
+
+  Sensors are placed along corridors: each has a corridor number, a
+  position along it (metres), an orientation (+1 if an A-hot-B-cold
+  event means travel toward increasing position, -1 the other way,
+  0 unknown), and optionally its aperture (metres of corridor its two
+  cells span, used with the dual-pulse gap to guess walking speed).
+
+  Timestamped events from all the sensors (sensor, polarity, width,
+  dual-pulse gap) are passed to feed() as they arrive. Each event either:
+
+    - is a duplicate: the same sensor re-triggering on a track within
+      the dedup time (one walker makes several events per sensor);
+    - extends a track: a neighbouring sensor on the same corridor, no
+      more than `spacing' metres from the track's last sensor, at a
+      plausible walking speed, in the track's direction;
+    - or starts a new track.
+
+  Where the sensor's orientation is known, an event's polarity gives
+  the walker's direction, which keeps two walkers crossing in a
+  corridor from trading events. Where the aperture is known, an
+  event's dual-pulse gap gives the walker's speed, which does the same
+  for a faster walker overtaking a slower one: an event more than
+  SRCORR_SPEEDTOL times faster or slower than a track isn't its
+  duplicate, and speed agreement weighs in choosing a neighbour.
+
+  Two false triggers on neighbouring sensors at walking pace look like
+  a short walk; where corridors have three or more sensors,
+  setMinSensors (3) keeps them out of the counts.
+
+  A track closes when nothing has joined it for `window' mS. Closed
+  tracks are handed to a callback with their direction, speed and
+  extent, and counted per corridor and direction; tracks that touched
+  fewer than minSensors sensors are reported but not counted.
+
+  Candidate tracks are found through a hash index keyed by (time
+  bucket, corridor, position cell); a bucket is 1/SRCORR_BUCKETS of the
+  window and a cell is `spacing' metres, so an event looks at only
+  SRCORR_BUCKETS + 1 buckets x 3 cells, never at every open track.
+  Tracks also sit on a ring of per-bucket lists, so closing stale
+  tracks costs nothing until they are due. All storage is fixed
+  size; if the track pool runs out, the oldest tracks are closed early.
+
+  Events may arrive up to `reorder' mS out of order (relative to the
+  newest seen); older ones are dropped and counted as late. A late
+  event can still join a track as a duplicate, or in front of a track
+  that has only one sensor so far (the walker passed it first); it
+  can't be put in the middle of a longer track, and starts its own.
+
+  Event times may wrap (a 32-bit millis()); they are unwrapped against
+  the newest seen, so no two live events may be 24 days apart.
+
+  tom jennings
+
+  18 oct 2026  written.
+  18 oct 2026  bounded reordering; gap speed against overtaking; clamp
+               polarity and orientation.
+  18 oct 2026  no expiry before the first `reorder' mS; buckets from a
+               64-bit clock, so millis() wrapping doesn't strand tracks.
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ version 2 as published by the Free Software Foundation.
+
+*/
+
+#ifndef SR_CORR
+#define SR_CORR
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef SRCORR_MAXSENSORS
+#define SRCORR_MAXSENSORS  1024             // sensor numbers 0 .. N-1
+#endif
+#ifndef SRCORR_MAXCORRIDORS
+#define SRCORR_MAXCORRIDORS 256
+#endif
+#ifndef SRCORR_MAXTRACKS
+#define SRCORR_MAXTRACKS   4096             // open tracks
+#endif
+#ifndef SRCORR_HASH
+#define SRCORR_HASH        8192             // index size, power of 2
+#endif
+#ifndef SRCORR_BUCKETS
+#define SRCORR_BUCKETS     8                // time buckets per window
+#endif
+#ifndef SRCORR_SPEEDTOL
+#define SRCORR_SPEEDTOL    1.5              // event vs track speed, max ratio for a duplicate
+#endif
+
+class SRCorr {
+
+public:
+
+struct event {
+  uint32_t t;                                // mS
+  uint16_t sensor;
+  int8_t polarity;                           // +1 A-hot-B-cold first, -1 A-cold-B-hot, 0 unknown
+  uint16_t width;                            // pulse width, mS
+  uint16_t gap;                              // dual-pulse gap, mS; 0 if none
+};
+
+struct track {
+  uint32_t firstT, lastT;                    // mS
+  float firstPos, lastPos;                   // metres
+  float speed;                               // metres/S; 0 unknown
+  uint16_t corridor;
+  uint16_t lastSensor;
+  uint16_t sensors;                          // sensors passed
+  uint16_t events;                           // events absorbed, duplicates included
+  int8_t dir;                                // +1 toward increasing position, -1 decreasing, 0 unknown
+};
+
+typedef void (* track_fn) (const track & tr, void * arg);
+
+	void begin (track_fn f, void * arg);
+	bool setSensor (unsigned n, uint16_t corridor, float pos, int8_t orient, float aperture);
+	void setWindow (uint32_t window, uint32_t dedup, float spacing, float vmin, float vmax);
+	void setMinSensors (uint16_t n) { minSensors= n; }
+	void setReorder (uint32_t r) { reorder= r < window ? r : window; }
+	bool feed (const struct event & e);
+	void flush (void);
+	uint32_t count (uint16_t corridor, int8_t dir);
+	uint32_t open (void) { return numOpen; }
+	uint32_t late (void) { return numLate; }
+
+private:
+
+static const int32_t NONE = -1;
+static const unsigned RING = 2 * SRCORR_BUCKETS + 4;   // ring slots, > buckets alive
+
+struct _sensor {
+  float pos;
+  float aperture;
+  uint16_t corridor;
+  int8_t orient;
+  bool used;
+};
+
+struct _node {
+  struct track tr;
+  uint32_t passT;                            // last sensor's first event, mS
+  int8_t hint;                               // direction from polarity, for one-sensor tracks
+  uint32_t bucket;                           // index key: time bucket,
+  int32_t cell;                              //   position cell (corridor is in tr)
+  int32_t hnext, hprev;                      // index chain
+  int32_t rnext, rprev;                      // ring list
+};
+
+	struct _sensor sensors [SRCORR_MAXSENSORS];
+	struct _node nodes [SRCORR_MAXTRACKS];
+	int32_t hash [SRCORR_HASH];
+	int32_t ring [RING];
+	int32_t freeList;
+	uint32_t counts [SRCORR_MAXCORRIDORS][3];
+
+	uint32_t window, dedup, reorder, bucketMs;
+	float spacing, vmin, vmax;
+	uint16_t minSensors;
+	uint64_t now;                              // newest event time, unwrapped
+	uint32_t oldest;                           // oldest bucket that may hold tracks
+	uint32_t numOpen, numLate;
+	bool started;
+
+	track_fn fn;
+	void * fnArg;
+
+	unsigned slot (uint32_t bucket, uint16_t corridor, int32_t cell);
+	int32_t cellOf (float pos) { return (int32_t) (pos >= 0 ? pos / spacing : pos / spacing - 1); }
+	void link (int32_t n);
+	void unlink (int32_t n);
+	void close (int32_t n);
+	void expire (uint32_t before);
+};
+
+
+void SRCorr::begin (track_fn f, void * arg) {
+unsigned i;
+
+  fn= f;
+  fnArg= arg;
+  memset (sensors, 0, sizeof sensors);
+  memset (counts, 0, sizeof counts);
+  for (i= 0; i < SRCORR_HASH; i++) hash[i]= NONE;
+  for (i= 0; i < RING; i++) ring[i]= NONE;
+  for (i= 0; i < SRCORR_MAXTRACKS; i++) nodes[i].hnext= i + 1 < SRCORR_MAXTRACKS ? (int32_t) i + 1 : NONE;
+  freeList= 0;
+  numOpen= numLate= 0;
+  now= oldest= 0;
+  started= false;
+  minSensors= 2;
+  reorder= 0;
+  setWindow (10000, 2000, 5.0, 0.5, 3.0);
+  setReorder (3000);
+}
+
+// place sensor N. returns false if N is out of range. ORIENT is
+// taken by its sign.
+//
+bool SRCorr::setSensor (unsigned n, uint16_t corridor, float pos, int8_t orient, float aperture) {
+
+  if (n >= SRCORR_MAXSENSORS || corridor >= SRCORR_MAXCORRIDORS) return false;
+  sensors[n].corridor= corridor;
+  sensors[n].pos= pos;
+  sensors[n].orient= (orient > 0) - (orient < 0);
+  sensors[n].aperture= aperture;
+  sensors[n].used= true;
+  return true;
+}
+
+// WINDOW, mS: a track closes when nothing joins it for this long.
+// DEDUP, mS: the same sensor again within this is the same walker.
+// SPACING, metres: furthest apart two sensors a walker goes between.
+// VMIN, VMAX, metres/S: plausible walking speeds.
+// WINDOW must be at least SPACING / VMIN, or slow walkers fall apart
+// into several tracks, and limits the reorder tolerance. call before
+// the first event.
+//
+void SRCorr::setWindow (uint32_t w, uint32_t d, float s, float lo, float hi) {
+
+  window= w;
+  dedup= d;
+  spacing= s;
+  vmin= lo;
+  vmax= hi;
+  bucketMs= w / SRCORR_BUCKETS + 1;
+  if (reorder > w) reorder= w;
+}
+
+// number of tracks counted on CORRIDOR in direction DIR (-1, 0, +1).
+//
+uint32_t SRCorr::count (uint16_t corridor, int8_t dir) {
+
+  if (corridor >= SRCORR_MAXCORRIDORS || dir < -1 || dir > 1) return 0;
+  return counts[corridor][dir + 1];
+}
+
+// one event. returns false if it was dropped (unknown sensor, or late).
+// POLARITY is taken by its sign.
+//
+bool SRCorr::feed (const struct event & e) {
+const struct _sensor * s;
+uint64_t t;
+uint32_t b, b0, bt, bn;
+int32_t c, i, best, dl, dp;
+float bestScore, score, d, v, ev, r;
+struct _node * p;
+struct track * tr;
+int8_t eh, td;
+int k;
+
+  if (e.sensor >= SRCORR_MAXSENSORS || ! sensors[e.sensor].used) return false;
+  s= &sensors[e.sensor];
+
+  // event times are a wrapping 32-bit mS clock (millis()); buckets come
+  // from a 64-bit copy of it, so they don't wrap with it.
+  //
+  if (! started) {
+    now= e.t;
+    oldest= e.t / bucketMs;
+    started= true;
+  }
+  t= now + (int32_t) (e.t - (uint32_t) now);
+  if (t > now) now= t;
+  if (now - t > reorder) {
+    ++numLate;
+    return false;
+  }
+
+  // close tracks nothing can join any more, allowing for late events.
+  //
+  if (now >= reorder) {
+    b= (now - reorder) / bucketMs;
+    if (b > SRCORR_BUCKETS + 1) expire (b - SRCORR_BUCKETS - 1);
+  }
+
+  // look for the best track to join: buckets covering the window, cells
+  // either side.
+  //
+  c= cellOf (s->pos);
+  eh= ((e.polarity > 0) - (e.polarity < 0)) * s->orient;   // direction of travel, if the sensor knows
+  ev= (s->aperture > 0 && e.gap > 0) ? s->aperture * 1000.0f / e.gap : 0;
+  bt= t / bucketMs;
+  bn= now / bucketMs;
+  b0= bt > SRCORR_BUCKETS + 1 ? bt - SRCORR_BUCKETS - 1 : 0;
+  best= NONE;
+  bestScore= 1e30;
+
+  for (b= b0; b <= bn; b++) {
+    for (k= -1; k <= 1; k++) {
+      for (i= hash[slot (b, s->corridor, c + k)]; i != NONE; i= nodes[i].hnext) {
+        p= &nodes[i];
+        tr= &p->tr;
+        if (p->bucket != b || p->cell != c + k || tr->corridor != s->corridor) continue;
+        dl= e.t - tr->lastT;                 // < 0 if this event is late
+        if (dl > (int32_t) window) continue;
+        if (dl < 0) dl= -dl;
+
+        // a walker going the other way.
+        //
+        td= tr->dir ? tr->dir : p->hint;
+        if (eh && td && eh != td) continue;
+
+        // speed from the dual-pulse gap vs the track's, 1 if either is unknown.
+        //
+        r= (ev > 0 && tr->speed > 0) ? (ev > tr->speed ? ev / tr->speed : tr->speed / ev) : 1;
+
+        // the same sensor again: a duplicate, if recent and at the track's
+        // speed; the most recent wins.
+        //
+        if (tr->lastSensor == e.sensor) {
+          if (dl > (int32_t) dedup) continue;
+          if (r > SRCORR_SPEEDTOL) continue;
+          score= -1.0f - 1.0f / (1.0f + dl);
+        }
+
+        // a neighbour: close enough, plausible speed, same direction.
+        // D is the way the walker went; a late event goes in front of a
+        // one-sensor track, so the walker went the other way.
+        //
+        else {
+          d= s->pos - tr->lastPos;
+          if (d == 0 || d > spacing || d < -spacing) continue;
+          dp= e.t - p->passT;
+          if (dp <= 0) {
+            if (dp == 0 || tr->sensors > 1) continue;
+            d= -d;
+            dp= -dp;
+          }
+          if (td && ((d > 0) != (td > 0))) continue;
+          if (eh && ((d > 0) != (eh > 0))) continue;
+          v= (d < 0 ? -d : d) * 1000.0f / dp;
+          if (v < vmin || v > vmax) continue;
+          score= r * (tr->speed > 0 ? (v > tr->speed ? v / tr->speed : tr->speed / v) : 1.5f);
+        }
+        if (score < bestScore) {
+          bestScore= score;
+          best= i;
+        }
+      }
+    }
+  }
+
+  // join it.
+  //
+  if (best != NONE) {
+    p= &nodes[best];
+    tr= &p->tr;
+    unlink (best);
+    ++tr->events;
+    if (tr->lastSensor != e.sensor) {
+      d= s->pos - tr->lastPos;
+      dp= e.t - p->passT;
+      if (dp > 0) {                          // after the last sensor
+        p->passT= e.t;
+        tr->lastPos= s->pos;
+        tr->lastSensor= e.sensor;
+      }
+      else {                                 // late, in front of the only one
+        d= -d;
+        dp= -dp;
+        tr->firstPos= s->pos;
+      }
+      v= (d < 0 ? -d : d) * 1000.0f / dp;
+      tr->speed= tr->speed > 0 ? (tr->speed + v) / 2 : v;
+      tr->dir= d > 0 ? 1 : -1;
+      ++tr->sensors;
+    }
+    if ((int32_t) (e.t - tr->lastT) > 0) {
+      tr->lastT= e.t;
+      p->bucket= bt;
+    }
+    if ((int32_t) (e.t - tr->firstT) < 0) tr->firstT= e.t;
+    p->cell= cellOf (tr->lastPos);
+    link (best);
+    return true;
+  }
+
+  // or start a new track. if the pool is empty, close the oldest.
+  //
+  while (freeList == NONE) expire (oldest + 1);
+
+  i= freeList;
+  p= &nodes[i];
+  freeList= p->hnext;
+  tr= &p->tr;
+  tr->firstT= tr->lastT= p->passT= e.t;
+  tr->firstPos= tr->lastPos= s->pos;
+  tr->corridor= s->corridor;
+  tr->lastSensor= e.sensor;
+  tr->sensors= tr->events= 1;
+  tr->dir= 0;
+  tr->speed= (s->aperture > 0 && e.gap > 0) ? s->aperture * 1000.0f / e.gap : 0;
+  p->hint= eh;
+  p->bucket= bt;
+  p->cell= c;
+  if ((int32_t) (p->bucket - oldest) < 0) oldest= p->bucket;
+  link (i);
+  ++numOpen;
+  return true;
+}
+
+// close every open track (eg. end of input).
+//
+void SRCorr::flush (void) {
+
+  expire ((uint32_t) (now / bucketMs) + RING);
+}
+
+
+unsigned SRCorr::slot (uint32_t bucket, uint16_t corridor, int32_t cell) {
+uint32_t h;
+
+  h= bucket * 0x9e3779b1u ^ corridor * 0x85ebca6bu ^ (uint32_t) cell * 0xc2b2ae35u;
+  return (h ^ (h >> 15)) & (SRCORR_HASH - 1);
+}
+
+// put node N on the index and the ring, per its bucket and cell.
+//
+void SRCorr::link (int32_t n) {
+struct _node * p;
+unsigned h, r;
+
+  p= &nodes[n];
+  h= slot (p->bucket, p->tr.corridor, p->cell);
+  p->hprev= NONE;
+  p->hnext= hash[h];
+  if (hash[h] != NONE) nodes[hash[h]].hprev= n;
+  hash[h]= n;
+
+  r= p->bucket % RING;
+  p->rprev= NONE;
+  p->rnext= ring[r];
+  if (ring[r] != NONE) nodes[ring[r]].rprev= n;
+  ring[r]= n;
+}
+
+void SRCorr::unlink (int32_t n) {
+struct _node * p;
+
+  p= &nodes[n];
+  if (p->hprev != NONE) nodes[p->hprev].hnext= p->hnext;
+  else hash[slot (p->bucket, p->tr.corridor, p->cell)]= p->hnext;
+  if (p->hnext != NONE) nodes[p->hnext].hprev= p->hprev;
+
+  if (p->rprev != NONE) nodes[p->rprev].rnext= p->rnext;
+  else ring[p->bucket % RING]= p->rnext;
+  if (p->rnext != NONE) nodes[p->rnext].rprev= p->rprev;
+}
+
+// report and count node N, and free it.
+//
+void SRCorr::close (int32_t n) {
+struct _node * p;
+struct track * tr;
+
+  p= &nodes[n];
+  tr= &p->tr;
+  unlink (n);
+  if (tr->sensors < 2) tr->dir= p->hint;
+  if (tr->sensors >= minSensors) ++counts[tr->corridor][tr->dir + 1];
+  if (fn) (* fn) (*tr, fnArg);
+
+  p->hnext= freeList;
+  freeList= n;
+  --numOpen;
+}
+
+// close all tracks in buckets before BEFORE.
+//
+void SRCorr::expire (uint32_t before) {
+int32_t i, next;
+
+  for (; (int32_t) (before - oldest) > 0; oldest++) {
+    for (i= ring[oldest % RING]; i != NONE; i= next) {
+      next= nodes[i].rnext;
+      if (nodes[i].bucket == oldest) close (i);
+    }
+    if (! numOpen) oldest= before;
+  }
+}
+
+
+#endif
@@ -0,0 +1,311 @@
+/*
+
+  Host driver for SRCorr, the cross-sensor event correlator.
+
+  Replays a recorded event stream against a topology, or runs a
+  synthetic building of walkers and false triggers and reports count
+  accuracy and per-event processing time.
+
+  Build (from the library directory):
+
+    g++ -O2 -I extras/correlator extras/correlator/corr.cpp -o corr
+
+  Run:
+
+    corr TOPOLOGY [EVENTS]   replay; EVENTS defaults to stdin
+    corr -b                  synthetic benchmark
+
+  TOPOLOGY, one sensor per line ('#' comments):
+
+    sensor corridor position [orient [aperture]]
+
+  EVENTS, one per line, in time order give or take the reorder
+  tolerance (-r):
+
+    t sensor polarity width gap
+
+  Replay prints each closed track, then the counts per corridor:
+
+    track corridor dir sensors events firstT lastT firstPos lastPos speed
+    count corridor minus unknown plus
+
+  Options:
+
+    -w window                mS a track stays open without events (10000)
+    -d dedup                 mS the same sensor is the same walker (2000)
+    -g spacing               metres between neighbouring sensors, max (5)
+    -n sensors               minimum sensors for a track to count (2)
+    -r reorder               mS an event may arrive out of order (3000)
+    -v                       benchmark: print each track
+
+  Benchmark options:
+
+    -c corridors             corridors (40)
+    -k sensors               sensors per corridor, 4 m apart (10)
+    -p walkers               walkers per corridor per minute (6)
+    -f rate                  false triggers per sensor per minute (0.5)
+    -m minutes               simulated time (60)
+
+  tom jennings
+
+  18 oct 2026
+
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#include "SRCorr.h"
+
+static SRCorr corr;                          // too big for the stack
+static bool verbose;
+
+static void printTrack (const SRCorr::track & tr, void *) {
+
+  printf ("track %u %d %u %u %lu %lu %.1f %.1f %.2f\n",
+    tr.corridor, tr.dir, tr.sensors, tr.events,
+    (unsigned long) tr.firstT, (unsigned long) tr.lastT,
+    tr.firstPos, tr.lastPos, tr.speed);
+}
+
+static void countTrack (const SRCorr::track & tr, void *) {
+
+  if (verbose) printTrack (tr, 0);
+}
+
+static double nowNs (void) {
+struct timespec ts;
+
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+
+/* replay */
+
+static int replay (const char * topo, const char * events) {
+FILE * f;
+char line [256];
+unsigned n, c, maxC, lines;
+float pos, ap;
+int orient, pol;
+unsigned long t, w, g;
+SRCorr::event e;
+
+  f= fopen (topo, "r");
+  if (! f) {
+    perror (topo);
+    return 2;
+  }
+  maxC= 0;
+  lines= 0;
+  while (fgets (line, sizeof line, f)) {
+    ++lines;
+    if (line[0] == '#' || line[0] == '\n') continue;
+    orient= 0;
+    ap= 0;
+    if (sscanf (line, "%u %u %f %d %f", &n, &c, &pos, &orient, &ap) < 3
+      || ! corr.setSensor (n, c, pos, orient, ap)) {
+      fprintf (stderr, "%s:%u: bad sensor\n", topo, lines);
+      return 2;
+    }
+    if (c > maxC) maxC= c;
+  }
+  fclose (f);
+
+  f= events ? fopen (events, "r") : stdin;
+  if (! f) {
+    perror (events);
+    return 2;
+  }
+  lines= 0;
+  while (fgets (line, sizeof line, f)) {
+    ++lines;
+    if (line[0] == '#' || line[0] == '\n') continue;
+    w= g= 0;
+    if (sscanf (line, "%lu %u %d %lu %lu", &t, &n, &pol, &w, &g) < 3) {
+      fprintf (stderr, "%s:%u: bad event\n", events ? events : "stdin", lines);
+      continue;
+    }
+    e.t= t;
+    e.sensor= n;
+    e.polarity= pol;
+    e.width= w;
+    e.gap= g;
+    if (! corr.feed (e)) fprintf (stderr, "%s:%u: dropped\n", events ? events : "stdin", lines);
+  }
+  if (f != stdin) fclose (f);
+  corr.flush ();
+
+  for (c= 0; c <= maxC; c++) {
+    printf ("count %u %lu %lu %lu\n", c,
+      (unsigned long) corr.count (c, -1), (unsigned long) corr.count (c, 0),
+      (unsigned long) corr.count (c, 1));
+  }
+  if (corr.late ()) printf ("late %lu\n", (unsigned long) corr.late ());
+  return 0;
+}
+
+
+/* synthetic benchmark */
+
+static int byTime (const void * a, const void * b) {
+uint32_t x, y;
+
+  x= ((const SRCorr::event *) a)->t;
+  y= ((const SRCorr::event *) b)->t;
+  return x < y ? -1 : x > y;
+}
+
+static double frand (void) { return rand () / (RAND_MAX + 1.0); }
+
+static int bench (unsigned corridors, unsigned perC, double walkers, double falseRate, unsigned minutes) {
+SRCorr::event * evs;
+unsigned maxEv, nEv, c, s, i, n, k, rep;
+unsigned long truth [2], got [3];
+double dur, t0, speed, tt, ns, worst, total;
+int dir;
+const float gap= 4.0;                        // metres between sensors
+const float aperture= 1.0;                   // metres across a sensor's two cells
+
+  for (c= 0; c < corridors; c++) {
+    for (s= 0; s < perC; s++) {
+      corr.setSensor (c * perC + s, c, s * gap, (s & 1) ? -1 : 1, aperture);
+    }
+  }
+
+  dur= minutes * 60000.0;
+  maxEv= (unsigned) (corridors * (walkers * minutes * perC * 3 + falseRate * minutes * perC) * 1.5) + 1000;
+  evs= (SRCorr::event *) malloc (maxEv * sizeof *evs);
+  if (! evs) {
+    fprintf (stderr, "no memory\n");
+    return 2;
+  }
+  nEv= 0;
+  truth[0]= truth[1]= 0;
+  srand (1);
+
+  // walkers arrive at random, walk the corridor end to end at a steady
+  // speed; each sensor they pass makes a dual-pulse event, sometimes a
+  // retrigger or two, with some timing jitter.
+  //
+  for (c= 0; c < corridors; c++) {
+    for (t0= 0; ; ) {
+      t0 += -log (1 - frand ()) * 60000.0 / walkers;
+      if (t0 >= dur) break;
+      dir= frand () < 0.5 ? 1 : -1;
+      ++truth[dir > 0];
+      speed= 0.7 + frand () * 1.1;
+      for (i= 0; i < perC; i++) {
+        s= dir > 0 ? i : perC - 1 - i;
+        tt= t0 + i * gap / speed * 1000.0 + (frand () - 0.5) * 300;
+        rep= frand () < 0.3 ? 1 + (frand () < 0.3) : 0;
+        for (k= 0; k <= rep && nEv < maxEv; k++) {
+          SRCorr::event & e= evs[nEv++];
+          e.t= (uint32_t) (tt + k * (600 + frand () * 600));
+          e.sensor= c * perC + s;
+          e.polarity= dir * ((s & 1) ? -1 : 1);
+          e.width= 200 + rand () % 300;
+          e.gap= k ? 0 : (uint16_t) (aperture / speed * 1000.0 * (0.8 + frand () * 0.4));
+        }
+      }
+    }
+
+    // false triggers: single events, no useful polarity.
+    //
+    for (t0= 0; ; ) {
+      t0 += -log (1 - frand ()) * 60000.0 / (falseRate * perC);
+      if (t0 >= dur || nEv >= maxEv) break;
+      SRCorr::event & e= evs[nEv++];
+      e.t= (uint32_t) t0;
+      e.sensor= c * perC + rand () % perC;
+      e.polarity= 0;
+      e.width= 100 + rand () % 200;
+      e.gap= 0;
+    }
+  }
+  qsort (evs, nEv, sizeof *evs, byTime);
+
+  total= worst= 0;
+  for (i= 0; i < nEv; i++) {
+    ns= nowNs ();
+    corr.feed (evs[i]);
+    ns= nowNs () - ns;
+    total += ns;
+    if (ns > worst) worst= ns;
+  }
+  corr.flush ();
+  free (evs);
+
+  got[0]= got[1]= got[2]= 0;
+  for (c= 0; c < corridors; c++) {
+    for (n= 0; n < 3; n++) got[n] += corr.count (c, n - 1);
+  }
+
+  printf ("%u sensors, %u corridors, %u minutes, %u events\n", corridors * perC, corridors, minutes, nEv);
+  printf ("walkers   minus %lu plus %lu\n", truth[0], truth[1]);
+  printf ("counted   minus %lu unknown %lu plus %lu (%+.1f%%)\n", got[0], got[1], got[2],
+    100.0 * ((double) got[0] + got[1] + got[2] - truth[0] - truth[1]) / (truth[0] + truth[1]));
+  printf ("per event mean %.0f nS, worst %.0f nS; %.0f events/S\n", total / nEv, worst, nEv / (total / 1e9));
+  return 0;
+}
+
+
+int main (int argc, char ** argv) {
+unsigned long window, dedup, reorder;
+unsigned corridors, perC, minutes, minS;
+double walkers, falseRate;
+float spacing;
+bool benchmark;
+int i;
+
+  window= 10000;
+  dedup= 2000;
+  reorder= 3000;
+  spacing= 5.0;
+  minS= 2;
+  corridors= 40;
+  perC= 10;
+  walkers= 6;
+  falseRate= 0.5;
+  minutes= 60;
+  benchmark= false;
+
+  for (i= 1; i < argc && argv[i][0] == '-'; i++) {
+    if (! strcmp (argv[i], "-b")) { benchmark= true; continue; }
+    if (! strcmp (argv[i], "-v")) { verbose= true; continue; }
+    if (i + 1 >= argc) break;
+    if (! strcmp (argv[i], "-w")) window= atol (argv[++i]);
+    else if (! strcmp (argv[i], "-d")) dedup= atol (argv[++i]);
+    else if (! strcmp (argv[i], "-g")) spacing= atof (argv[++i]);
+    else if (! strcmp (argv[i], "-n")) minS= atol (argv[++i]);
+    else if (! strcmp (argv[i], "-r")) reorder= atol (argv[++i]);
+    else if (! strcmp (argv[i], "-c")) corridors= atol (argv[++i]);
+    else if (! strcmp (argv[i], "-k")) perC= atol (argv[++i]);
+    else if (! strcmp (argv[i], "-p")) walkers= atof (argv[++i]);
+    else if (! strcmp (argv[i], "-f")) falseRate= atof (argv[++i]);
+    else if (! strcmp (argv[i], "-m")) minutes= atol (argv[++i]);
+    else break;
+  }
+
+  corr.begin (benchmark ? countTrack : printTrack, 0);
+  corr.setWindow (window, dedup, spacing, 0.5, 3.0);
+  corr.setMinSensors (minS);
+  corr.setReorder (reorder);
+
+  if (benchmark) {
+    if (! corridors || ! perC || corridors * perC > SRCORR_MAXSENSORS || corridors > SRCORR_MAXCORRIDORS) {
+      fprintf (stderr, "too many sensors\n");
+      return 2;
+    }
+    return bench (corridors, perC, walkers, falseRate, minutes);
+  }
+  if (i >= argc) {
+    fprintf (stderr, "usage: corr [options] TOPOLOGY [EVENTS] | corr -b [options]\n");
+    return 2;
+  }
+  return replay (argv[i], i + 1 < argc ? argv[i + 1] : 0);
+}
@@ -0,0 +1,47 @@
+/*
+
+  Host stand-in for Arduino.h, for the golden-output harness.
+
+  millis() and micros() run off a clock the harness sets; analogRead()
+  returns the trace sample at that time, and notes that it was called
+  (one call per SRPIR sensor tick). Serial goes to stdout.
+
+  tom jennings
+
+  18 oct 2026
+
+*/
+
+#ifndef GOLDEN_ARDUINO_H
+#define GOLDEN_ARDUINO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <math.h>
+
+extern uint32_t goldenT;                     // the clock, mS
+extern int (* goldenADC) (uint32_t t);       // the trace
+extern bool goldenRead;                      // analogRead() was called
+
+inline uint32_t millis (void) { return goldenT; }
+inline uint32_t micros (void) { return goldenT * 1000; }
+inline int analogRead (int) { goldenRead= true; return (* goldenADC) (goldenT); }
+inline void pinMode (int, int) { }
+
+#define INPUT_PULLUP 2
+#define F(s) (s)
+
+struct goldenSerial {
+  void begin (long) { }
+  void print (const char * s) { fputs (s, stdout); }
+  void print (double f) { printf ("%.2f", f); }
+  void print (long n) { printf ("%ld", n); }
+  void print (unsigned long n) { printf ("%lu", n); }
+  void print (int n) { printf ("%d", n); }
+  void print (unsigned n) { printf ("%u", n); }
+  template <class X> void println (X x) { print (x); putchar ('\n'); }
+  void println (void) { putchar ('\n'); }
+};
+extern goldenSerial Serial;
+
+#endif
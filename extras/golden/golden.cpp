@@ -0,0 +1,736 @@
+/*
+
+  Golden-output regression harness for SRPIR, runs on the host.
+
+  A frozen copy of the original float detector (SRSmooth -> SRSMPID ->
+  findPulse, as of the 2020 SRPIR, written out longhand here so later
+  library changes can't move it) is run over reference traces to make
+  the golden output: the filter output at every sensor tick, and the
+  SINGLE and DUAL mode event times.
+
+  Each backend (SRPIR as compiled, in some mode or configuration) is
+  then run over the same traces on a simulated millis() clock, and
+  compared against the golden output. Most poll loop(); the -sched
+  backends run SRPIR as an SRSched task instead (begin (pin, S, prio),
+  S.run(), event()).
+
+    filter   every tick at the same time as a golden tick, |dv| <= vtol
+    events   matched in time order within +/- skew mS (and up to lead mS
+             early, for backends meant to fire first); unmatched golden
+             events are missed, unmatched backend events are extra.
+    stray    events outside every pass are false triggers; a backend
+             may not have more of them than golden (spikes fire golden
+             SINGLE too).
+    early    EARLY events later retracted (earlyStatus()) are left out
+             of the matching and counted on their own, per 1000 fired.
+
+  SRPulse (unless SRPIR_NOPULSE) is checked on its own first:
+  synthetic square +/- lobe pairs go straight to SRPulse::sample(),
+  and gap, widths, areas, peaks, asymmetry, direction and speed class
+  must come out exactly as worked out by hand.
+
+  For the built-in traces, where the passes are known, it also reports
+  per-pass detection: passes the backend caught that the golden output
+  also caught, the backend's latency (pass onset to first event) p50/p90,
+  and the mean latency penalty over the golden output. That, and the
+  sensor ticks per second, is how the adaptive rate backends are judged.
+
+  Defaults are bit-exact: vtol 0, skew 0, no missed or extra events.
+  Backends that differ by design (EARLY) carry their own event
+  tolerances; the filter output must still match.
+
+  The adaptive rate backends (-ad, -ad-sched) have the per-sample and
+  per-event checks off (vtol 1e9, missed and extra -1): idle sampling
+  changes the filter output and the event times by design, and golden
+  is not resampled to match. maxdv, missed, extra and skew are still
+  printed. Only two checks can fail them: passes golden caught but the
+  backend didn't (per 1000), and false triggers over golden's.
+
+  Build (from the library directory), once per configuration:
+
+    g++ -O2 -I extras/golden -I . extras/golden/golden.cpp -o golden
+    g++ -O2 -DSRPIR_SMALL -I extras/golden -I . extras/golden/golden.cpp -o golden-small
+
+  Run:
+
+    golden                   reference and backends, in-process
+    golden record DIR        write the golden output to DIR/<trace>.gold
+    golden check DIR         compare backends against DIR/<trace>.gold
+
+  Options:
+
+    -v vtol                  filter output tolerance
+    -s skew                  event time tolerance, mS
+    -l lead                  how much earlier than golden an event may be, mS
+    -m n                     missed events allowed, -1 any
+    -x n                     extra events allowed, -1 any
+    -r n                     EARLY retractions allowed, per 1000 events fired
+    -f n                     false triggers (events outside any pass) allowed
+                             over golden's, -1 any
+    -t file                  also use this trace: one ADC reading per line,
+                             one line per SENSETIME (25 mS)
+    -q                       short built-in traces only
+
+  Exit status is 0 if everything passed.
+
+  tom jennings
+
+  18 oct 2026
+
+*/
+
+#include <Arduino.h>
+#include <SRPIR.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include <algorithm>
+
+uint32_t goldenT;
+int (* goldenADC) (uint32_t t);
+bool goldenRead;
+goldenSerial Serial;
+
+
+/* -------------------------------------------------------------------------- */
+/* Traces. Deterministic: the noise is a hash of the time, not a PRNG stream,
+   so a sample's value doesn't depend on how the trace is walked. */
+
+const uint32_t TICK = 25;                    // SRPIR SENSETIME, mS
+const uint32_t HOUR = 3600000;
+
+struct trace {
+  const char * name;
+  uint32_t len;                              // mS
+  uint32_t seed;
+  uint32_t gapMin, gapMax;                   // between passes, mS; 0 == none
+  float noise;                               // sigma, ADC counts
+  uint32_t spikes;                           // one-tick spike about every N mS; 0 == none
+  std::vector<int> file;                     // or, samples from a file
+
+  trace () : name (0), len (0), seed (0), gapMin (0), gapMax (0), noise (0), spikes (0) { }
+  trace (const char * n, uint32_t l, uint32_t s, uint32_t g0, uint32_t g1, float f, uint32_t k) :
+    name (n), len (l), seed (s), gapMin (g0), gapMax (g1), noise (f), spikes (k) { }
+};
+
+struct pass {
+  uint32_t t0, len;                          // start, duration, mS
+  float amp;                                 // signed; sign is direction
+};
+
+static std::vector<pass> passes;
+static size_t passCursor;
+static const trace * cur;
+
+static uint64_t hash (uint64_t x) {
+
+  x += 0x9e3779b97f4a7c15ULL;
+  x= (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x= (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+static double uniform (uint64_t x) {
+
+  return ((hash (x) >> 11) + 0.5) / 9007199254740992.0;
+}
+
+static void makePasses (const trace & tr) {
+uint64_t k;
+uint32_t t;
+pass p;
+
+  passes.clear ();
+  if (! tr.gapMax) return;
+  k= (uint64_t) tr.seed << 32;
+  for (t= 15000; t < tr.len; t += tr.gapMin + hash (k++) % (tr.gapMax - tr.gapMin)) {
+    p.t0= t;
+    p.len= 300 + hash (k++) % 1500;
+    p.amp= 15 + hash (k++) % 70;
+    if (hash (k++) & 1) p.amp= -p.amp;
+    passes.push_back (p);
+  }
+}
+
+static int traceADC (uint32_t t) {
+double v, u1, u2;
+uint64_t k;
+size_t i;
+
+  if (! cur->file.empty ()) {
+    i= t / TICK;
+    if (i >= cur->file.size ()) i= cur->file.size () - 1;
+    return cur->file[i];
+  }
+
+  k= ((uint64_t) cur->seed << 32) ^ t;
+  u1= uniform (k * 2);
+  u2= uniform (k * 2 + 1);
+  v= 512 + cur->noise * sqrt (-2 * log (u1)) * cos (6.283185307179586 * u2);
+
+  // passes are in time order and the clock only goes forward.
+  //
+  while (passCursor < passes.size () && passes[passCursor].t0 + passes[passCursor].len <= t) ++passCursor;
+  for (i= passCursor; i < passes.size () && passes[i].t0 <= t; i++) {
+    v += passes[i].amp * sin (6.283185307179586 * (t - passes[i].t0) / passes[i].len);
+  }
+
+  if (cur->spikes && hash (k ^ 0x5a5a5a5aULL) % (cur->spikes / TICK) == 0) v += 40;
+  return (int) floor (v + 0.5);
+}
+
+static void useTrace (const trace & tr) {
+
+  cur= &tr;
+  makePasses (tr);
+  passCursor= 0;
+  goldenADC= traceADC;
+}
+
+
+/* -------------------------------------------------------------------------- */
+/* Golden output. */
+
+struct golden {
+  std::vector<float> v;                      // filter output, tick 1, 2, 3 ...
+  std::vector<uint32_t> single, dual;        // event times, mS
+};
+
+/* The reference: the 2020 SRPIR/SRSMPID/SRSmooth arithmetic, verbatim. */
+
+struct smoother {
+  float fh, sf;
+  float smooth (float v) { fh= (sf * v) + ((1.00 - sf) * fh); return fh; }
+};
+
+struct finder {
+  bool s;
+  long t;
+
+  int find (int h, int thresh, int width, uint32_t now) {
+  int r;
+
+    r= 0;
+    switch (s) {
+      case false:
+        if (((thresh > 0) && (h >= thresh)) ||
+            ((thresh < 0) && (h <= thresh))) {
+          s= true;
+          t= now;
+        }
+        break;
+      case true:
+        if (((thresh > 0) && (h < thresh)) ||
+            ((thresh < 0) && (h > thresh))) {
+          s= false;
+          r= now - t;
+          if (r < width) r= 0;
+        }
+    }
+    return r;
+  }
+};
+
+static void reference (golden & g) {
+const float sf = (float) TICK / 500.0f;      // SENSETIME / SENSELPTC, SENSETC
+const float gain = 5.0;
+const int threshold = 8;
+const unsigned long holdoff = 10000, maxevent = 20000;
+smoother lp, integ;
+finder fs, fd;
+float r, v, prev_d, ip;
+bool h;
+long ht;
+uint32_t t;
+int n;
+
+  g.v.clear (); g.single.clear (); g.dual.clear ();
+  n= traceADC (0);
+  lp.fh= n; lp.sf= sf;
+  n= lp.smooth (n);
+  integ.fh= n; integ.sf= sf;
+  prev_d= 0;
+  fs.s= fd.s= false;
+  h= false;
+  ht= 0;
+
+  for (t= TICK; t < cur->len; t += TICK) {
+    r= traceADC (t);
+    v= lp.smooth (r);
+    ip= integ.smooth (v * -gain);
+    v= (v * gain) + ip + ((v - prev_d) * gain);
+    prev_d= lp.fh;
+    g.v.push_back (v);
+
+    if (t < holdoff) continue;
+
+    if (fs.find (v, threshold, 35, t) > 0) g.single.push_back (t);
+
+    if (! h) {
+      if (fd.find (v, threshold, 35, t) > 0) {
+        h= true;
+        ht= t;
+      }
+    }
+    else {
+      if (fd.find (v, -threshold, 35, t) > 0) {
+        h= false;
+        g.dual.push_back (t);
+      }
+      if ((unsigned long) (t - ht) > maxevent) h= false;
+    }
+  }
+}
+
+static bool save (const golden & g, const char * path) {
+FILE * f;
+uint32_t n;
+
+  if (! (f= fopen (path, "wb"))) return false;
+  fputs ("SRGOLD1\n", f);
+  n= g.v.size ();      fwrite (&n, 4, 1, f); fwrite (g.v.data (), 4, n, f);
+  n= g.single.size (); fwrite (&n, 4, 1, f); fwrite (g.single.data (), 4, n, f);
+  n= g.dual.size ();   fwrite (&n, 4, 1, f); fwrite (g.dual.data (), 4, n, f);
+  return fclose (f) == 0;
+}
+
+static bool load (golden & g, const char * path) {
+FILE * f;
+char magic [8];
+uint32_t n;
+bool ok;
+
+  if (! (f= fopen (path, "rb"))) return false;
+  ok= fread (magic, 8, 1, f) == 1 && memcmp (magic, "SRGOLD1\n", 8) == 0;
+  ok= ok && fread (&n, 4, 1, f) == 1; if (ok) { g.v.resize (n); ok= fread (g.v.data (), 4, n, f) == n; }
+  ok= ok && fread (&n, 4, 1, f) == 1; if (ok) { g.single.resize (n); ok= fread (g.single.data (), 4, n, f) == n; }
+  ok= ok && fread (&n, 4, 1, f) == 1; if (ok) { g.dual.resize (n); ok= fread (g.dual.data (), 4, n, f) == n; }
+  fclose (f);
+  return ok;
+}
+
+
+/* -------------------------------------------------------------------------- */
+/* Backends. */
+
+struct tolerance {
+  float vtol;                                // filter output
+  long skew;                                 // event time, mS
+  long lead;                                 // backend event may also be this early, mS
+  long missed, extra;                        // events; -1 == any number
+  long lost;                                 // passes golden caught but the backend didn't, per 1000
+  long retract;                              // EARLY events retracted, per 1000 fired
+  long stray;                                // events outside any pass, over golden's; -1 == any number
+};
+
+struct backend {
+  const char * name;
+  bool dual;                                 // compare against golden DUAL, else SINGLE
+  tolerance tol;
+  void (* setup) (SRPIR & P);
+  bool sched;                                // run as an SRSched task, else poll loop()
+};
+
+static void setSingle (SRPIR & P) { P.setMode (SRPIR::SINGLE); }
+static void setDual (SRPIR & P) { P.setMode (SRPIR::DUAL); }
+#ifndef SRPIR_NOEARLY
+static void setEarly (SRPIR & P) { P.setMode (SRPIR::EARLY); }
+#endif
+#ifndef SRPIR_NOADAPT
+static void setSingleAdapt (SRPIR & P) { P.setMode (SRPIR::SINGLE); P.setAdaptive (true); }
+static void setDualAdapt (SRPIR & P) { P.setMode (SRPIR::DUAL); P.setAdaptive (true); }
+#endif
+
+static const backend backends [] = {
+  { "single",          false, { 0, 0, 0, 0, 0, 0, 0, 0 },         setSingle,      false },
+  { "single-sched",    false, { 0, 0, 0, 0, 0, 0, 0, 0 },         setSingle,      true },
+  { "dual",            true,  { 0, 0, 0, 0, 0, 0, 0, 0 },         setDual,        false },
+#ifndef SRPIR_NOEARLY
+  { "early",           false, { 0, 0, 2000, 0, 0, 0, 50, 0 },     setEarly,       false },   // fires up to a pass before SINGLE
+#endif
+#ifndef SRPIR_NOADAPT
+  { "single-ad",       false, { 1e9, 1000, 0, -1, -1, 10, 0, 0 }, setSingleAdapt, false },   // filter differs while idle; judged per pass, no added false triggers
+  { "dual-ad",         true,  { 1e9, 1000, 0, -1, -1, 30, 0, 0 }, setDualAdapt,   false },   // DUAL often arms on a lone spike, which idle sampling can miss
+  { "single-ad-sched", false, { 1e9, 1000, 0, -1, -1, 10, 0, 0 }, setSingleAdapt, true },    // re-timed through SRSched::setInterval()
+#endif
+};
+
+struct result {
+  size_t ticks, compared, events, matched, missed, extra;
+  size_t stray, gstray;                      // events outside any pass, backend and golden
+  size_t fired, provisional, retracted;      // EARLY: events, of them provisional, of those retracted
+  double maxdv;
+  long maxskew;
+  double meanskew;                           // backend - golden, matched events
+  size_t passes, caught, both;               // passes, golden caught, backend caught too
+  long p50, p90;                             // backend pass latency, mS
+  double penalty;                            // mean backend - golden pass latency, mS
+  double secs;
+};
+
+// latency from each pass onset to the first event within it (or 3 S after), -1 if none.
+//
+static void passLatency (const std::vector<uint32_t> & ev, std::vector<long> & lat) {
+size_t i, j;
+
+  lat.assign (passes.size (), -1);
+  for (i= j= 0; i < passes.size (); i++) {
+    while (j < ev.size () && ev[j] < passes[i].t0) ++j;
+    if (j < ev.size () && ev[j] < passes[i].t0 + passes[i].len + 3000) lat[i]= ev[j] - passes[i].t0;
+  }
+}
+
+// events outside every pass.
+//
+static size_t outside (const std::vector<uint32_t> & ev) {
+size_t i, j, n;
+
+  for (i= j= n= 0; i < ev.size (); i++) {
+    while (j < passes.size () && passes[j].t0 + passes[j].len + 3000 <= ev[i]) ++j;
+    if (j >= passes.size () || ev[i] < passes[j].t0) ++n;
+  }
+  return n;
+}
+
+static void runBackend (const backend & b, const golden & g, result & res) {
+std::vector<uint32_t> ev;
+uint32_t t;
+size_t i;
+double dv;
+clock_t c;
+bool e;
+SRPIR P;
+SRSched S;
+
+  res.ticks= res.compared= 0;
+  res.fired= res.provisional= res.retracted= 0;
+  res.maxdv= 0;
+  c= clock ();
+
+  passCursor= 0;
+  goldenT= 0;
+  if (b.sched) {
+    S.begin ();
+    P.begin (0, S, 0);
+  }
+  else P.begin (0);
+  (* b.setup) (P);
+
+  for (t= 1; t < cur->len; t++) {
+    goldenT= t;
+    goldenRead= false;
+    if (b.sched) {
+      S.run ();
+      e= P.event ();
+    }
+    else e= P.loop ();
+    if (e) {
+      ev.push_back (t);
+      ++res.fired;
+    }
+    if (! goldenRead) continue;
+
+#ifndef SRPIR_NOEARLY
+    // a retracted event never happened, as far as matching goes; it is
+    // always the last one, the pulse it was fired on has just ended.
+    //
+    switch (P.earlyStatus ()) {
+      case SRPIR::EARLY_PROVISIONAL:
+        ++res.provisional;
+        break;
+      case SRPIR::EARLY_RETRACTED:
+        ++res.retracted;
+        ev.pop_back ();
+        break;
+    }
+#endif
+
+    ++res.ticks;
+    if (t % TICK) continue;
+    i= t / TICK - 1;
+    if (i >= g.v.size ()) continue;
+    ++res.compared;
+    dv= fabs ((double) P.value () - g.v[i]);
+    if (dv > res.maxdv || dv != dv) res.maxdv= dv;
+  }
+  res.secs= (double) (clock () - c) / CLOCKS_PER_SEC;
+
+  // match events in time order.
+  //
+  const std::vector<uint32_t> & ge= b.dual ? g.dual : g.single;
+  long sk= b.tol.skew;
+  long lead= b.tol.lead;
+  size_t j;
+
+  res.events= ge.size ();
+  res.matched= res.missed= res.extra= 0;
+  res.maxskew= 0;
+  res.meanskew= 0;
+  for (i= j= 0; i < ge.size (); i++) {
+    while (j < ev.size () && (long) ev[j] < (long) ge[i] - sk - lead) { ++res.extra; ++j; }
+    if (j < ev.size () && (long) ev[j] <= (long) ge[i] + sk) {
+      long d= labs ((long) ev[j] - (long) ge[i]);
+      if (d > res.maxskew) res.maxskew= d;
+      res.meanskew += (long) ev[j] - (long) ge[i];
+      ++res.matched;
+      ++j;
+    }
+    else ++res.missed;
+  }
+  res.extra += ev.size () - j;
+  if (res.matched) res.meanskew /= res.matched;
+
+  // events outside every pass (onset to 3 S after) are false triggers,
+  // not chatter on a real pass. golden has its own (spikes); a backend
+  // may have a different set, but not more of them.
+  //
+  res.stray= outside (ev);
+  res.gstray= outside (ge);
+
+  // per pass.
+  //
+  std::vector<long> gl, bl, l;
+
+  passLatency (ge, gl);
+  passLatency (ev, bl);
+  res.passes= passes.size ();
+  res.caught= res.both= 0;
+  res.penalty= 0;
+  for (i= 0; i < gl.size (); i++) {
+    if (gl[i] < 0) continue;
+    ++res.caught;
+    if (bl[i] < 0) continue;
+    ++res.both;
+    res.penalty += bl[i] - gl[i];
+    l.push_back (bl[i]);
+  }
+  if (res.both) res.penalty /= res.both;
+  std::sort (l.begin (), l.end ());
+  res.p50= l.empty () ? 0 : l[l.size () / 2];
+  res.p90= l.empty () ? 0 : l[l.size () * 9 / 10];
+}
+
+
+/* -------------------------------------------------------------------------- */
+/* SRPulse. */
+
+#ifndef SRPIR_NOPULSE
+struct lobeSpec {
+  uint32_t t0, width;                        // mS, multiples of TICK
+  float v;                                   // signed level
+};
+
+struct pulseCase {
+  const char * name;
+  uint32_t start;                            // first sample, mS; SRPulse::begin() is at 0
+  lobeSpec first, second;
+  bool pairs;                                // false: no pair expected
+  uint8_t speed;
+};
+
+// square lobes, sampled every TICK: a lobe's area is |v| x the time its
+// samples span (the first sample after begin() spans none), its peak |v|
+// at its first sample, and the gap is from start to start.
+//
+static const pulseCase pulseCases [] = {
+  { "walk",    500,   { 1000,  600, 30 },  { 2000,  900, -20 }, true,  SRPulse::SPEED_WALK },
+  { "minus",   500,   { 1000,  500, -40 }, { 1500,  500, 20 },  true,  SRPulse::SPEED_WALK },
+  { "fast",    500,   { 1000,  250, 20 },  { 1250,  250, -20 }, true,  SRPulse::SPEED_FAST },
+  { "slow",    500,   { 1000,  800, 20 },  { 3000,  800, -20 }, true,  SRPulse::SPEED_SLOW },
+  { "late",    10000, { 10000, 1000, 20 }, { 11500, 1000, -20 }, true, SRPulse::SPEED_WALK },  // first sample (after a holdoff) is in the lobe
+  { "glitch",  500,   { 1000,  100, 20 },  { 1200,  600, -20 }, false, 0 },                    // first lobe too narrow
+};
+
+static float level (const lobeSpec & l, uint32_t t) {
+
+  return t >= l.t0 && t < l.t0 + l.width ? l.v : 0;
+}
+
+static bool near (float a, float b) {
+
+  return fabs (a - b) <= 1e-4 * (fabs (a) + fabs (b) + 1);
+}
+
+// area of lobe S, sampled from START on.
+//
+static float area (const lobeSpec & s, uint32_t start) {
+
+  return fabs (s.v) * (s.t0 + s.width - std::max (s.t0, start + TICK));
+}
+
+static bool checkLobe (const SRPulse::lobe & l, const lobeSpec & s, uint32_t start) {
+
+  return l.start == s.t0 && l.width == s.width && l.peakT == s.t0 && near (l.peak, fabs (s.v))
+    && near (l.area, area (s, start)) && l.polarity == (s.v > 0 ? 1 : -1);
+}
+
+static int pulseCheck (void) {
+const int thresh = 8;
+const uint16_t glitch = 200, maxGap = 20000;
+int fails, n;
+uint32_t t, end;
+float a1, a2;
+bool ok;
+
+  fails= 0;
+  for (const pulseCase & c : pulseCases) {
+    SRPulse P= SRPulse ();                   // zeroed, so last() is defined if nothing pairs
+
+    goldenT= 0;
+    P.begin (glitch, maxGap);
+    end= c.second.t0 + c.second.width + 1000;
+    n= 0;
+    for (t= c.start; t < end; t += TICK) {
+      if (P.sample (level (c.first, t) + level (c.second, t), thresh, t)) ++n;
+    }
+
+    const SRPulse::result & r= P.last ();
+    a1= area (c.first, c.start);
+    a2= area (c.second, c.start);
+    if (! c.pairs) ok= n == 0;
+    else {
+      ok= n == 1 && r.T == c.second.t0 + c.second.width && r.gap == c.second.t0 - c.first.t0;
+      ok= ok && checkLobe (r.first, c.first, c.start) && checkLobe (r.second, c.second, c.start);
+      ok= ok && near (r.asymmetry, (a1 - a2) / (a1 + a2));
+      ok= ok && r.direction == (c.first.v > 0 ? 1 : -1) && r.speed == c.speed;
+    }
+    if (! ok) ++fails;
+
+    if (c.pairs) {
+      printf ("pulse    %-15s pairs %d  gap %5u  width %4u/%-4u  area %6.0f/%-6.0f  peak %3.0f/%-3.0f  asymmetry %6.3f  direction %+d  speed %u  %s\n",
+        c.name, n, r.gap, r.first.width, r.second.width, r.first.area, r.second.area,
+        r.first.peak, r.second.peak, r.asymmetry, r.direction, r.speed, ok ? "PASS" : "FAIL");
+    }
+    else printf ("pulse    %-15s pairs %d  %s\n", c.name, n, ok ? "PASS" : "FAIL");
+  }
+  return fails;
+}
+#endif
+
+
+/* -------------------------------------------------------------------------- */
+
+static bool loadFile (trace & tr, const char * path) {
+FILE * f;
+int n;
+
+  if (! (f= fopen (path, "r"))) return false;
+  while (fscanf (f, "%d", &n) == 1) tr.file.push_back (n);
+  fclose (f);
+  tr.len= tr.file.size () * TICK;
+  return ! tr.file.empty ();
+}
+
+static void usage (void) {
+
+  fprintf (stderr, "usage: golden [record DIR | check DIR] [-v vtol] [-s skew] [-l lead] [-m missed] [-x extra] [-r retract] [-f stray] [-t tracefile] [-q]\n");
+  exit (2);
+}
+
+int main (int argc, char ** argv) {
+std::vector<trace> traces;
+const char * dir = 0;
+bool record = false, quick = false;
+tolerance over = { -1, -1, -1, -2, -2, -1, -1, -2 };  // command line overrides
+char path [1024];
+int i, fails;
+golden g;
+trace tr;
+
+  i= 1;
+  if (i < argc && (! strcmp (argv[i], "record") || ! strcmp (argv[i], "check"))) {
+    record= ! strcmp (argv[i], "record");
+    if (++i >= argc) usage ();
+    dir= argv[i++];
+  }
+  for (; i < argc; i++) {
+    if (! strcmp (argv[i], "-q")) { quick= true; continue; }
+    if (i + 1 >= argc) usage ();
+    if (! strcmp (argv[i], "-v")) over.vtol= atof (argv[++i]);
+    else if (! strcmp (argv[i], "-s")) over.skew= atol (argv[++i]);
+    else if (! strcmp (argv[i], "-l")) over.lead= atol (argv[++i]);
+    else if (! strcmp (argv[i], "-m")) over.missed= atol (argv[++i]);
+    else if (! strcmp (argv[i], "-x")) over.extra= atol (argv[++i]);
+    else if (! strcmp (argv[i], "-r")) over.retract= atol (argv[++i]);
+    else if (! strcmp (argv[i], "-f")) over.stray= atol (argv[++i]);
+    else if (! strcmp (argv[i], "-t")) {
+      tr= trace ();
+      tr.name= argv[++i];
+      if (! loadFile (tr, tr.name)) { fprintf (stderr, "golden: can't read %s\n", tr.name); return 2; }
+      traces.push_back (tr);
+    }
+    else usage ();
+  }
+
+  //                 name     length       seed  gapMin gapMax noise  spikes
+  traces.push_back (trace ("quiet", 2 * HOUR,    1,    0,     0,     2.0f, 0));
+  traces.push_back (trace ("busy",  2 * HOUR,    2,    3000,  15000, 2.0f, 0));
+  traces.push_back (trace ("spiky", 2 * HOUR,    3,    8000,  28000, 3.0f, 20000));
+  if (! quick) {
+    traces.push_back (trace ("long", 10 * HOUR, 4,    8000,  28000, 2.0f, 60000));
+  }
+
+  fails= 0;
+#ifndef SRPIR_NOPULSE
+  if (! record) fails += pulseCheck ();
+#endif
+  for (const trace & t : traces) {
+    useTrace (t);
+
+    // the golden output: computed, from file, or computed and written.
+    //
+    if (dir) {
+      const char * base= strrchr (t.name, '/');
+      snprintf (path, sizeof path, "%s/%s.gold", dir, base ? base + 1 : t.name);
+    }
+    if (dir && ! record) {
+      if (! load (g, path)) { fprintf (stderr, "golden: can't read %s\n", path); return 2; }
+    }
+    else reference (g);
+
+    if (record) {
+      if (! save (g, path)) { fprintf (stderr, "golden: can't write %s\n", path); return 2; }
+      printf ("%-8s %8zu ticks  %5zu single  %5zu dual  -> %s\n", t.name, g.v.size (), g.single.size (), g.dual.size (), path);
+      continue;
+    }
+
+    for (const backend & b : backends) {
+      backend bb = b;
+      result r;
+
+      if (over.vtol >= 0) bb.tol.vtol= over.vtol;
+      if (over.skew >= 0) bb.tol.skew= over.skew;
+      if (over.lead >= 0) bb.tol.lead= over.lead;
+      if (over.missed >= -1) bb.tol.missed= over.missed;
+      if (over.extra >= -1) bb.tol.extra= over.extra;
+      if (over.retract >= 0) bb.tol.retract= over.retract;
+      if (over.stray >= -1) bb.tol.stray= over.stray;
+
+      useTrace (t);
+      runBackend (bb, g, r);
+
+      bool ok= r.maxdv <= bb.tol.vtol;
+      ok= ok && (bb.tol.missed < 0 || (long) r.missed <= bb.tol.missed);
+      ok= ok && (long) (r.caught - r.both) * 1000 <= bb.tol.lost * (long) r.caught;
+      ok= ok && (bb.tol.extra < 0 || (long) r.extra <= bb.tol.extra);
+      ok= ok && (long) r.retracted * 1000 <= bb.tol.retract * (long) r.fired;
+      ok= ok && (bb.tol.stray < 0 || (long) r.stray - (long) r.gstray <= bb.tol.stray);
+      if (! ok) ++fails;
+
+      printf ("%-8s %-15s %8zu ticks %5.1f/s %8zu compared  maxdv %-9.3g  events %5zu/%-5zu missed %-4zu extra %-4zu stray %3zu/%-3zu skew max %5ld mean %7.1f mS  %6.2f Msamples/s  %s\n",
+        t.name, bb.name, r.ticks, r.ticks * 1000.0 / t.len, r.compared, r.maxdv, r.matched, r.events, r.missed, r.extra, r.stray, r.gstray,
+        r.maxskew, r.meanskew, r.secs > 0 ? r.ticks / r.secs / 1e6 : 0.0, ok ? "PASS" : "FAIL");
+      if (r.provisional) {
+        printf ("%-8s %-15s fired %zu, provisional %zu, retracted %zu\n", "", "", r.fired, r.provisional, r.retracted);
+      }
+      if (r.passes) {
+        printf ("%-8s %-15s passes %zu, golden caught %zu, backend too %zu; latency p50 %ld p90 %ld mS, penalty %.1f mS\n",
+          "", "", r.passes, r.caught, r.both, r.p50, r.p90, r.penalty);
+      }
+    }
+  }
+  return fails ? 1 : 0;
+}